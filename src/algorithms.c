@@ -6,194 +6,514 @@
  **/
 /*-----------------------------------------------------------------*/
 
+#include "column_costs.h"
+#include "message_queue.h"
+#include "node_pool.h"
+#include "pattern_database.h"
+#include "priority_queue.h"
+#include "search_stats.h"
 #include "state.h"
+#include "state_index.h"
+#include "state_set.h"
+#include "state_simd.h"
+#include "transposition_table.h"
+#include <assert.h>
 #include <limits.h>
+#include <stdarg.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <threads.h>
+#include <time.h>
 
 /*-----------------------------------------------------------------*/
 
-bool depth_first_search(State *current, States *path, int **infos) {
-    States pending, seen, sub_states;
-    State next;
-    init_states(&pending);
-    init_states(&seen);
-    init_state(&next);
-    push_state(&pending, current);
+/**
+ * Stream the searches of the calling thread print to, stdout when NULL.
+ */
+static _Thread_local FILE *output = NULL;
+
+void set_search_output(FILE *stream) {
+    output = stream;
+}
+
+static void search_printf(const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    vfprintf(output != NULL ? output : stdout, format, arguments);
+    va_end(arguments);
+}
+
+/**
+ * Memory of the transposition table of each IDA* search, none when 0.
+ */
+static size_t ida_star_table_bytes = 0;
+
+/**
+ * Key of the transposition table of the IDA* searches of each thread, freed
+ * when the thread exits.
+ */
+static tss_t ida_star_table_key;
+static once_flag ida_star_table_once = ONCE_FLAG_INIT;
+
+void set_ida_star_table_size(size_t bytes) {
+    ida_star_table_bytes = bytes;
+}
+
+static void release_ida_star_table(void *table) {
+    free_transposition_table(table);
+    free(table);
+}
+
+static void create_ida_star_table_key(void) {
+    tss_create(&ida_star_table_key, release_ida_star_table);
+}
+
+/**
+ * Returns the transposition table of the IDA* searches of the calling
+ * thread, emptied, or NULL if they have none. The table is kept from one
+ * search to the next, so its memory is only allocated and faulted in once.
+ */
+static TranspositionTable *ida_star_table(void) {
+    if (ida_star_table_bytes == 0)
+        return NULL;
+    call_once(&ida_star_table_once, create_ida_star_table_key);
+    TranspositionTable *table = tss_get(ida_star_table_key);
+    if (table == NULL) {
+        table = malloc(sizeof(TranspositionTable));
+        assert(table != NULL);
+        init_transposition_table(table, ida_star_table_bytes);
+        tss_set(ida_star_table_key, table);
+    } else {
+        clear_transposition_table(table);
+    }
+    return table;
+}
+
+static void print_closed_list_stats(StateSet *closed) {
+    search_printf("Closed list: %llu states, load factor %.2f, mean probe "
+                  "%.2f, max probe %llu\n",
+                  closed->size, state_set_load_factor(closed),
+                  state_set_mean_probe(closed), closed->counters.max_probe);
+}
+
+static void print_visited_set_stats(StateBitset *visited) {
+    search_printf("Visited set: %llu states, %llu bytes\n", visited->size,
+                  state_bitset_bytes(visited));
+}
+
+static void print_transposition_table_stats(TranspositionTable *table) {
+    search_printf("Transposition table: %llu states, %zu bytes, hit rate "
+                  "%.2f, replacement rate %.2f\n",
+                  table->size, transposition_table_bytes(table),
+                  transposition_hit_rate(table),
+                  transposition_replacement_rate(table));
+}
+
+/**
+ * Rebuilds the path from the root of a search to one of its nodes. The goal
+ * is stored in current and the states of the path, the root excluded, are
+ * pushed on path from the goal back to the root.
+ */
+static void build_path(NodePool *pool, NodeId goal, State *current,
+                       States *path) {
+    Node *node = get_node(pool, goal);
+    unpack_state(node->state, current);
+    current->depth = node->depth;
+    reserve_states(path, path->size + node->depth);
+    while (node->parent != NO_PARENT) {
+        State state;
+        unpack_state(node->state, &state);
+        state.depth = node->depth;
+        push_state(path, &state);
+        node = get_node(pool, node->parent);
+    }
+}
+
+/**
+ * Rebuilds a path from the packed states between the root and the goal, the
+ * same way build_path() does.
+ */
+static void build_packed_path(const PackedState *states, int goal_depth,
+                              State *current, States *path) {
+    unpack_state(states[goal_depth], current);
+    current->depth = goal_depth;
+    reserve_states(path, path->size + goal_depth);
+    for (int i = goal_depth; i > 0; i--) {
+        State state;
+        unpack_state(states[i], &state);
+        state.depth = i;
+        push_state(path, &state);
+    }
+}
+
+/**
+ * Relabels the columns of a path found over canonical states: states[0] holds
+ * the root as given, and each of the following canonical states is replaced
+ * by the successor of the previous state that has its canonical form.
+ */
+static void relabel_canonical_path(PackedState *states, int length) {
+    for (int i = 1; i <= length; i++) {
+        Movement movement;
+        bool found = canonical_movement(states[i - 1], states[i], &movement);
+        assert(found);
+        (void)found;
+        states[i] = apply_movement_to_packed_state(states[i - 1], movement);
+    }
+}
+
+/**
+ * Rebuilds the path from the root of a search over canonical states to one
+ * of its nodes, the same way build_path() does, in the columns of the root.
+ */
+static void build_canonical_path(NodePool *pool, NodeId goal, State *current,
+                                 States *path) {
+    int length = get_node(pool, goal)->depth;
+    PackedState *states = malloc((length + 1) * sizeof(PackedState));
+    assert(states != NULL);
+    for (NodeId id = goal; id != NO_PARENT; id = get_node(pool, id)->parent) {
+        states[get_node(pool, id)->depth] = get_node(pool, id)->state;
+    }
+    states[0] = pack_state(current);
+    relabel_canonical_path(states, length);
+    build_packed_path(states, length, current, path);
+    free(states);
+}
+
+/**
+ * Returns the index of the canonical form of a packed state, which keys the
+ * visited sets of the depth-first searches so that the states differing only
+ * by the order of their columns are visited once.
+ */
+static StateIndex canonical_state_index(PackedState packed) {
+    return packed_state_index(canonical_packed_state(packed));
+}
+
+bool depth_first_search(State *current, States *path, SearchStats *stats) {
+    NodePool pool;
+    NodeStack pending;
+    StateBitset visited;
+    Movement movements[MAX_MOVEMENTS];
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    init_node_pool(&pool);
+    init_node_stack(&pending);
+    init_state_bitset(&visited);
+    push_node(&pending, new_node(&pool, pack_state(current), NO_PARENT, 0));
+    add_index_to_bitset(&visited, canonical_state_index(pack_state(current)));
+    bool found = false;
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
     while (pending.size > 0) {
-        (*infos)[2]++;
-        next = *pop_state(&pending);
-        push_state(&seen, &next);
-        if (is_goal_state(next)) {
-            *current = copy_state(&next);
-            printf("Goal state found!\n");
-            *infos[0] = seen.size;
-            State *state = current;
-            while (state->predecessor != NULL) {
-                push_state(path, state);
-                state = state->predecessor;
-            }
-            return true;
-        } else {
-            sub_states = possible_states(next);
-            for (unsigned long long i = 0; i < sub_states.size; i++) {
-                (*infos)[1]++;
-                if (!is_state_in_states(pending, sub_states.stack[i]) &&
-                    !is_state_in_states(seen, sub_states.stack[i])) {
-                    push_state(&pending, &sub_states.stack[i]);
-                }
-            }
+        NodeId next = pop_node(&pending);
+        Node node = *get_node(&pool, next);
+        STATS_ADD(stats, seen, 1);
+        if (is_packed_goal_state(node.state)) {
+            search_printf("Goal state found!\n");
+            print_visited_set_stats(&visited);
+            STATS_PHASE(stats, SEARCH_PHASE_PATH);
+            build_path(&pool, next, current, path);
+            found = true;
+            break;
         }
+        STATS_ADD(stats, expansions, 1);
+        int nb_movement = packed_possible_movements(node.state, movements);
+        for (int i = 0; i < nb_movement; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child =
+                apply_movement_to_packed_state(node.state, movements[i]);
+            // The visited set holds the canonical form of every state ever
+            // pushed, so it covers both the pending and the already expanded
+            // states, whatever the order of their columns
+            if (add_index_to_bitset(&visited, canonical_state_index(child)))
+                push_node(&pending,
+                          new_node(&pool, child, next, node.depth + 1));
+            else
+                STATS_ADD(stats, duplicates, 1);
+        }
+        STATS_PEAK(stats, open_peak, pending.size);
     }
-    for (unsigned long long i = 0; i < sub_states.size; i++) {
-        free(sub_states.stack[i].predecessor);
-    }
-    free(sub_states.stack);
-    printf("Goal state not found!\n");
-    return false;
+    STATS_PEAK(stats, closed_peak, visited.size);
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free_node_pool(&pool);
+    free_node_stack(&pending);
+    free_state_bitset(&visited);
+    if (!found)
+        search_printf("Goal state not found!\n");
+    return found;
 }
 
 bool depth_first_search_capped(State *current, States *path, int depth_max,
-                               int **infos) {
-    States pending, seen, sub_states;
-    State next;
-    init_states(&pending);
-    init_states(&seen);
-    init_state(&next);
-    push_state(&pending, current);
-    pending.stack[0].depth = 0;
+                               SearchStats *stats) {
+    NodePool pool;
+    NodeStack pending;
+    StateBitset visited;
+    Movement movements[MAX_MOVEMENTS];
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    init_node_pool(&pool);
+    init_node_stack(&pending);
+    init_state_bitset(&visited);
+    push_node(&pending, new_node(&pool, pack_state(current), NO_PARENT, 0));
+    add_index_to_bitset(&visited, canonical_state_index(pack_state(current)));
+    bool found = false;
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
     while (pending.size > 0) {
-        (*infos)[2]++;
-        next = *pop_state(&pending);
-        push_state(&seen, &next);
-        if (is_goal_state(next)) {
-            *current = copy_state(&next);
-            *infos[0] = seen.size;
-            printf("Goal state found on depth %d!\n", depth_max);
-            State *state = current;
-            while (state->predecessor != NULL) {
-                push_state(path, state);
-                state = state->predecessor;
-            }
-            return true;
-        } else {
-            sub_states = possible_states(next);
-            for (unsigned long long i = 0; i < sub_states.size; i++) {
-                (*infos)[1]++;
-                sub_states.stack[i].depth = next.depth + 1;
-                if (!is_state_in_states(pending, sub_states.stack[i]) &&
-                    !is_state_in_states(seen, sub_states.stack[i]) &&
-                    sub_states.stack[i].depth <= depth_max)
-                    push_state(&pending, &sub_states.stack[i]);
-            }
+        NodeId next = pop_node(&pending);
+        Node node = *get_node(&pool, next);
+        STATS_ADD(stats, seen, 1);
+        if (is_packed_goal_state(node.state)) {
+            search_printf("Goal state found on depth %d!\n", depth_max);
+            print_visited_set_stats(&visited);
+            STATS_PHASE(stats, SEARCH_PHASE_PATH);
+            build_path(&pool, next, current, path);
+            found = true;
+            break;
         }
+        if (node.depth >= depth_max)
+            continue;
+        STATS_ADD(stats, expansions, 1);
+        int nb_movement = packed_possible_movements(node.state, movements);
+        for (int i = 0; i < nb_movement; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child =
+                apply_movement_to_packed_state(node.state, movements[i]);
+            if (add_index_to_bitset(&visited, canonical_state_index(child)))
+                push_node(&pending,
+                          new_node(&pool, child, next, node.depth + 1));
+            else
+                STATS_ADD(stats, duplicates, 1);
+        }
+        STATS_PEAK(stats, open_peak, pending.size);
     }
-    for (unsigned long long i = 0; i < sub_states.size; i++) {
-        free(sub_states.stack[i].predecessor);
-    }
-    free(sub_states.stack);
-    printf("Goal state not found on depth %d!\n", depth_max);
-    return false;
+    STATS_PEAK(stats, closed_peak, visited.size);
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free_node_pool(&pool);
+    free_node_stack(&pending);
+    free_state_bitset(&visited);
+    if (!found)
+        search_printf("Goal state not found on depth %d!\n", depth_max);
+    return found;
 }
 
-bool iterative_deepening(State *current, States *path, int **infos) {
+bool iterative_deepening(State *current, States *path, SearchStats *stats) {
     for (int i = 0; i < 100; i++) {
-        if (depth_first_search_capped(current, path, i, infos))
+        STATS_ADD(stats, iterations, 1);
+        if (depth_first_search_capped(current, path, i, stats))
             return true;
     }
     return false;
 }
 
+/**
+ * Defines the number of bits of a column in a PackedState.
+ */
+#define PACKED_COLUMN_BITS (4 * STATE_HEIGHT)
+
+/*
+ * Both heuristics sum a cost per column, so a movement only changes the
+ * costs of its two columns. These tables hold the cost of every packed
+ * column, for O(1) heuristic deltas.
+ */
+static once_flag column_costs_once = ONCE_FLAG_INIT;
+static uint8_t misplaced_cubes_of_columns[1 << PACKED_COLUMN_BITS];
+static uint8_t manhattan_distance_of_columns[STATE_WIDTH]
+                                            [1 << PACKED_COLUMN_BITS];
+
+static void init_column_costs(void) {
+    for (int bits = 0; bits < 1 << PACKED_COLUMN_BITS; bits++) {
+        uint8_t column[STATE_HEIGHT];
+        int height = 0;
+        for (int j = 0; j < STATE_HEIGHT; j++) {
+            column[j] = (bits >> (4 * j)) & 0xF;
+            height += column[j] != 0;
+        }
+        misplaced_cubes_of_columns[bits] =
+            misplaced_cubes_of_column(column, height, STATE_HEIGHT);
+        for (int i = 0; i < STATE_WIDTH; i++) {
+            manhattan_distance_of_columns[i][bits] =
+                manhattan_distance_of_column(column, height, i, STATE_HEIGHT);
+        }
+    }
+}
+
+static void ensure_column_costs(void) {
+    call_once(&column_costs_once, init_column_costs);
+}
+
+static inline int packed_column(PackedState packed, int column) {
+    return (packed >> PACKED_CELL_OFFSET(column, 0)) &
+           ((1 << PACKED_COLUMN_BITS) - 1);
+}
+
 int misplaced_cubes(State state) {
+#ifdef STATE_SIMD
+    return misplaced_cubes_simd(&state);
+#else
     int misplaced = 0;
     for (int i = 0; i < STATE_WIDTH; i++) {
-        if (state.nb_element[i] != 0 && state.nb_element[i] != 3)
-            misplaced++;
-        for (int j = 0; j < STATE_HEIGHT - 1; j++) {
-            if (state.state[i][j] - state.state[i][j + 1] != 1 &&
-                state.state[i][j] != 0)
-                misplaced++;
-        }
+        misplaced += misplaced_cubes_of_column(
+            state.state[i], state.nb_element[i], STATE_HEIGHT);
     }
     return misplaced;
+#endif
+}
+
+int misplaced_cubes_delta(PackedState state, PackedState successor,
+                          Movement movement) {
+    ensure_column_costs();
+    const uint8_t *costs = misplaced_cubes_of_columns;
+    return costs[packed_column(successor, movement.from)] +
+           costs[packed_column(successor, movement.to)] -
+           costs[packed_column(state, movement.from)] -
+           costs[packed_column(state, movement.to)];
 }
 
 int manhattan_distance(State state) {
+#ifdef STATE_SIMD
+    return manhattan_distance_simd(&state);
+#else
     int distance = 0;
     for (int i = 0; i < STATE_WIDTH; i++) {
-        if (state.nb_element[i] != 0 && state.nb_element[i] != 3)
-            distance++;
-        for (int j = 0; j < STATE_HEIGHT - 1; j++) {
-            int element = state.state[i][j];
-            if (element != 0) {
-                int goal_i = (element - 1) / STATE_HEIGHT;
-                int goal_j = (element - 1) % STATE_HEIGHT;
-                if (element - state.state[i][j + 1] != 1)
-                    distance += abs(i - goal_i) + abs(j - goal_j);
-            }
-        }
+        distance += manhattan_distance_of_column(
+            state.state[i], state.nb_element[i], i, STATE_HEIGHT);
     }
     return distance;
+#endif
+}
+
+int manhattan_distance_delta(PackedState state, PackedState successor,
+                             Movement movement) {
+    ensure_column_costs();
+    const uint8_t *from = manhattan_distance_of_columns[movement.from];
+    const uint8_t *to = manhattan_distance_of_columns[movement.to];
+    return from[packed_column(successor, movement.from)] +
+           to[packed_column(successor, movement.to)] -
+           from[packed_column(state, movement.from)] -
+           to[packed_column(state, movement.to)];
+}
+
+void manhattan_distance_of_successors(const State *state,
+                                      const Movement movements[],
+                                      int nb_movement, int distances[]) {
+    State successors[MAX_MOVEMENTS];
+    for (int i = 0; i < nb_movement; i++) {
+        successors[i] = *state;
+        apply_movement_to_state(&successors[i], movements[i]);
+    }
+    int i = 0;
+#ifdef __AVX2__
+    for (; i + 1 < nb_movement; i += 2) {
+        manhattan_distance_pair_avx2(&successors[i], &successors[i + 1],
+                                     &distances[i]);
+    }
+#endif
+    for (; i < nb_movement; i++) {
+        distances[i] = manhattan_distance(successors[i]);
+    }
 }
 
 double f(State state, int (*heuristic)(State), int step_cost) {
     return (state.depth * step_cost) + heuristic(state);
 }
 
+/**
+ * Returns the cost function value of a packed state reached at some depth.
+ */
+static double packed_f(PackedState packed, int depth, int (*heuristic)(State),
+                       int step_cost) {
+    State state;
+    unpack_state(packed, &state);
+    state.depth = depth;
+    return f(state, heuristic, step_cost);
+}
+
+/**
+ * Checks if a heuristic gives the same value to the states differing only by
+ * the order of their columns, so that they may share a closed set or
+ * transposition table entry keyed by their canonical form. The Manhattan
+ * distance measures the distances to the columns of one goal state, so a
+ * state whose columns are swapped may have a lower cost and must not be
+ * pruned by its twin.
+ */
+static bool is_column_symmetric(int (*heuristic)(State)) {
+    return heuristic == misplaced_cubes || heuristic == pattern_database;
+}
+
+/**
+ * Returns the key of a packed state in a closed set or transposition table,
+ * its canonical form if the heuristic is column symmetric.
+ */
+static PackedState heuristic_key(PackedState packed, bool canonical) {
+    return canonical ? canonical_packed_state(packed) : packed;
+}
+
 double depth_first_search_capped_heuristic(State *current, States *path,
                                            double threshold,
                                            int (*heuristic)(State),
-                                           int step_cost, int **infos) {
-    States pending, seen;
-    State next;
+                                           int step_cost, SearchStats *stats) {
+    NodePool pool;
+    NodeStack pending;
+    StateSet closed;
+    Movement movements[MAX_MOVEMENTS];
     double min_cost_exceeding_threshold = INT_MAX;
-    init_states(&pending);
-    init_states(&seen);
-    push_state(&pending, current);
-    pending.stack[0].depth = 0;
+    bool canonical = is_column_symmetric(heuristic);
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    init_node_pool(&pool);
+    init_node_stack(&pending);
+    init_state_set(&closed);
+    push_node(&pending, new_node(&pool, pack_state(current), NO_PARENT, 0));
+    add_key_to_set(&closed, heuristic_key(pack_state(current), canonical));
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
     while (pending.size > 0) {
-        (*infos)[2]++;
-        next = *pop_state(&pending);
-        push_state(&seen, &next);
-        if (is_goal_state(next)) {
-            *current = copy_state(&next);
-            *infos[0] = seen.size;
-            State *state = current;
-            while (state->predecessor != NULL) {
-                push_state(path, state);
-                state = state->predecessor;
-            }
-            return -1;
-        } else {
-            States sub_states = possible_states(next);
-            for (unsigned long long i = 0; i < sub_states.size; i++) {
-                (*infos)[1]++;
-                sub_states.stack[i].depth = next.depth + 1;
-                double cost = f(sub_states.stack[i], heuristic, step_cost);
-                if (cost <= threshold &&
-                    !is_state_in_states(pending, sub_states.stack[i]) &&
-                    !is_state_in_states(seen, sub_states.stack[i])) {
-                    push_state(&pending, &sub_states.stack[i]);
-                } else if (cost > threshold) {
-                    min_cost_exceeding_threshold =
-                        min_cost_exceeding_threshold < cost
-                            ? min_cost_exceeding_threshold
-                            : cost;
-                }
+        NodeId next = pop_node(&pending);
+        Node node = *get_node(&pool, next);
+        STATS_ADD(stats, seen, 1);
+        if (is_packed_goal_state(node.state)) {
+            print_closed_list_stats(&closed);
+            STATS_PHASE(stats, SEARCH_PHASE_PATH);
+            build_path(&pool, next, current, path);
+            min_cost_exceeding_threshold = -1;
+            break;
+        }
+        STATS_ADD(stats, expansions, 1);
+        int nb_movement = packed_possible_movements(node.state, movements);
+        for (int i = 0; i < nb_movement; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child =
+                apply_movement_to_packed_state(node.state, movements[i]);
+            int depth = node.depth + 1;
+            double cost = packed_f(child, depth, heuristic, step_cost);
+            if (cost > threshold) {
+                min_cost_exceeding_threshold =
+                    min_cost_exceeding_threshold < cost
+                        ? min_cost_exceeding_threshold
+                        : cost;
+            } else if (add_key_to_set(&closed,
+                                      heuristic_key(child, canonical))) {
+                // The nodes keep their own columns, so the path needs no
+                // relabelling
+                push_node(&pending, new_node(&pool, child, next, depth));
+            } else {
+                STATS_ADD(stats, duplicates, 1);
             }
         }
+        STATS_PEAK(stats, open_peak, pending.size);
     }
+    STATS_PEAK(stats, closed_peak, closed.size);
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free_node_pool(&pool);
+    free_node_stack(&pending);
+    free_state_set(&closed);
     return min_cost_exceeding_threshold;
 }
 
 bool iterative_deepening_with_heuristic(State *current, States *path,
                                         int (*heuristic)(State), int step_cost,
-                                        int **infos) {
+                                        SearchStats *stats) {
     double threshold = misplaced_cubes(*current);
     while (true) {
+        STATS_ADD(stats, iterations, 1);
         double temp = depth_first_search_capped_heuristic(
-            current, path, threshold, heuristic, step_cost, infos);
+            current, path, threshold, heuristic, step_cost, stats);
         if (temp == -1)
             if (temp == -1)
                 return true;
@@ -201,4 +521,1639 @@ bool iterative_deepening_with_heuristic(State *current, States *path,
             return false;
         threshold = temp;
     }
-}
\ No newline at end of file
+}
+
+bool a_star(State *current, States *path, int (*heuristic)(State),
+            int step_cost, SearchStats *stats) {
+    NodePool pool;
+    PriorityQueue open;
+    StateMap generated;
+    Movement movements[MAX_MOVEMENTS];
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    init_node_pool(&pool);
+    init_priority_queue(&open);
+    init_state_map(&generated);
+    PackedState root = pack_state(current);
+    NodeId root_id = new_node(&pool, root, NO_PARENT, 0);
+    put_in_state_map(&generated, root, root_id);
+    insert_in_queue(&open, root_id, packed_f(root, 0, heuristic, step_cost),
+                    0);
+    bool found = false;
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    while (open.size > 0) {
+        NodeId next = pop_min_priority(&open);
+        Node node = *get_node(&pool, next);
+        STATS_ADD(stats, seen, 1);
+        if (is_packed_goal_state(node.state)) {
+            search_printf("Goal state found!\n");
+            search_printf("Closed list: %llu states, load factor %.2f, max "
+                          "probe %llu\n",
+                          generated.size - open.size,
+                          (double)generated.size / (double)generated.capacity,
+                          generated.counters.max_probe);
+            STATS_PHASE(stats, SEARCH_PHASE_PATH);
+            build_path(&pool, next, current, path);
+            found = true;
+            break;
+        }
+        STATS_ADD(stats, expansions, 1);
+        int nb_movement = packed_possible_movements(node.state, movements);
+        for (int i = 0; i < nb_movement; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child =
+                apply_movement_to_packed_state(node.state, movements[i]);
+            int depth = node.depth + 1;
+            NodeId id;
+            if (!get_from_state_map(&generated, child, &id)) {
+                id = new_node(&pool, child, next, depth);
+                put_in_state_map(&generated, child, id);
+                insert_in_queue(
+                    &open, id,
+                    packed_f(child, depth, heuristic, step_cost), depth);
+            } else if (is_node_in_queue(&open, id) &&
+                       depth < get_node(&pool, id)->depth) {
+                // A generated state out of the queue is closed
+                get_node(&pool, id)->parent = next;
+                get_node(&pool, id)->depth = depth;
+                decrease_priority(
+                    &open, id, packed_f(child, depth, heuristic, step_cost),
+                    depth);
+            } else {
+                STATS_ADD(stats, duplicates, 1);
+            }
+        }
+        STATS_PEAK(stats, open_peak, open.size);
+        STATS_PEAK(stats, closed_peak, generated.size - open.size);
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free_node_pool(&pool);
+    free_priority_queue(&open);
+    free_state_map(&generated);
+    if (!found)
+        search_printf("Goal state not found!\n");
+    return found;
+}
+
+/**
+ * Value returned by an IDA* pass that reached a goal state.
+ */
+#define IDA_STAR_FOUND -1
+
+/**
+ * @struct IdaStarContext
+ * @brief State of an IDA* search shared by its recursive calls.
+ *
+ * state is the state of the current node, modified in place. path holds the
+ * packed states from the root to the current node and movements the
+ * movements between them. When cancelled is set, a pass stops as soon as it
+ * reads true from it. heuristic_delta is the incremental form of the
+ * heuristic, NULL if it has none. table is the transposition table of the
+ * search, NULL if it has none, keyed by canonical states when canonical_keys
+ * is set. nb_seen counts the nodes visited and
+ * nb_expanded those expanded, whether or not the statistics are compiled in.
+ */
+typedef struct s_ida_star_context {
+    State state;
+    PackedState *path;
+    Movement *movements;
+    int capacity;
+    int goal_depth;
+    uint64_t nb_seen;
+    uint64_t nb_expanded;
+    int (*heuristic)(State);
+    int (*heuristic_delta)(PackedState, PackedState, Movement);
+    int step_cost;
+    SearchStats *stats;
+    atomic_bool *cancelled;
+    TranspositionTable *table;
+    bool canonical_keys;
+} IdaStarContext;
+
+/**
+ * Sets the heuristic of an IDA* search, with its incremental form when it
+ * has one, and how its transposition table is keyed.
+ */
+static void set_ida_star_heuristic(IdaStarContext *context,
+                                   int (*heuristic)(State)) {
+    context->heuristic = heuristic;
+    context->canonical_keys = is_column_symmetric(heuristic);
+    context->heuristic_delta = NULL;
+    if (heuristic == misplaced_cubes)
+        context->heuristic_delta = misplaced_cubes_delta;
+    else if (heuristic == manhattan_distance)
+        context->heuristic_delta = manhattan_distance_delta;
+}
+
+static bool is_on_path(IdaStarContext *context, PackedState packed,
+                       int depth) {
+    for (int i = depth; i >= 0; i--) {
+        if (context->path[i] == packed)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Runs an IDA* pass below the current node of a search, whose cost function
+ * value is cost. With an incremental heuristic, the cost of a child is the
+ * cost of its parent plus the step cost and the heuristic delta of the
+ * movement, checked against a full computation in Debug builds. The bound
+ * of a node in the transposition table may exceed its heuristic, in which
+ * case it stands for the cost of the node.
+ */
+static double ida_star_pass(IdaStarContext *context, int depth,
+                            double threshold, double cost) {
+    if (context->cancelled != NULL &&
+        atomic_load_explicit(context->cancelled, memory_order_relaxed))
+        return INT_MAX;
+    context->nb_seen++;
+    if (cost > threshold)
+        return cost;
+    PackedState packed = context->path[depth];
+    if (is_packed_goal_state(packed)) {
+        context->goal_depth = depth;
+        return IDA_STAR_FOUND;
+    }
+    double depth_cost = (double)depth * context->step_cost;
+    // With a column symmetric heuristic, the states differing by the order
+    // of their columns share their entry
+    PackedState key = 0;
+    if (context->table != NULL) {
+        // cost is kept for the heuristic deltas of the children
+        key = heuristic_key(packed, context->canonical_keys);
+        const TranspositionEntry *entry =
+            probe_transposition_table(context->table, key);
+        if (entry != NULL && depth_cost + entry->bound > threshold)
+            return depth_cost + entry->bound;
+    }
+    context->nb_expanded++;
+    STATS_PEAK(context->stats, open_peak, depth + 1);
+    if (depth + 1 == context->capacity) {
+        context->capacity *= 2;
+        context->path = realloc(context->path,
+                                context->capacity * sizeof(PackedState));
+        context->movements = realloc(context->movements,
+                                     context->capacity * sizeof(Movement));
+    }
+    const HeightMoves *moves = height_moves(height_signature(packed));
+    double min_cost_exceeding_threshold = INT_MAX;
+    for (int i = 0; i < moves->nb_movement; i++) {
+        Movement movement = moves->movements[i];
+        // Parent-move pruning: never undo the movement that led here
+        if (depth > 0 && movement.from == context->movements[depth - 1].to &&
+            movement.to == context->movements[depth - 1].from)
+            continue;
+        STATS_ADD(context->stats, generations, 1);
+        PackedState child = apply_movement_to_packed_state(packed, movement);
+        if (is_on_path(context, child, depth)) {
+            STATS_ADD(context->stats, duplicates, 1);
+            continue;
+        }
+        context->path[depth + 1] = child;
+        context->movements[depth] = movement;
+        apply_movement_to_state(&context->state, movement);
+        context->state.depth = depth + 1;
+        double child_cost =
+            context->heuristic_delta != NULL
+                ? cost + context->step_cost +
+                      context->heuristic_delta(packed, child, movement)
+                : f(context->state, context->heuristic, context->step_cost);
+#ifdef CHECK_HEURISTIC_DELTAS
+        assert(child_cost ==
+               f(context->state, context->heuristic, context->step_cost));
+#endif
+        double result =
+            ida_star_pass(context, depth + 1, threshold, child_cost);
+        undo_movement_to_state(&context->state, movement);
+        context->state.depth = depth;
+        if (result == IDA_STAR_FOUND)
+            return IDA_STAR_FOUND;
+        if (result < min_cost_exceeding_threshold)
+            min_cost_exceeding_threshold = result;
+    }
+    // No goal lies below within the threshold: the cheapest path down
+    // exceeds it, a bound for the next visits of the node
+    if (context->table != NULL && min_cost_exceeding_threshold != INT_MAX)
+        store_in_transposition_table(context->table, key, depth,
+                                     min_cost_exceeding_threshold -
+                                         depth_cost);
+    return min_cost_exceeding_threshold;
+}
+
+bool ida_star(State *current, States *path, int (*heuristic)(State),
+              int step_cost, SearchStats *stats) {
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    IdaStarContext context = {
+        .state = *current,
+        .capacity = 64,
+        .step_cost = step_cost,
+        .stats = stats,
+    };
+    set_ida_star_heuristic(&context, heuristic);
+    context.state.predecessor = NULL;
+    context.state.depth = 0;
+    context.path = malloc(context.capacity * sizeof(PackedState));
+    context.movements = malloc(context.capacity * sizeof(Movement));
+    context.path[0] = pack_state(current);
+    context.table = ida_star_table();
+    double root_cost = f(context.state, heuristic, step_cost);
+    double threshold = root_cost;
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    while (true) {
+        STATS_ADD(stats, iterations, 1);
+        context.nb_seen = 0;
+        threshold = ida_star_pass(&context, 0, threshold, root_cost);
+        if (threshold == IDA_STAR_FOUND || threshold == INT_MAX)
+            break;
+    }
+    // The states seen are those of the last pass
+    STATS_ADD(stats, seen, context.nb_seen);
+    STATS_ADD(stats, expansions, context.nb_expanded);
+    bool found = threshold == IDA_STAR_FOUND;
+    if (found) {
+        STATS_PHASE(stats, SEARCH_PHASE_PATH);
+        build_packed_path(context.path, context.goal_depth, current, path);
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    if (context.table != NULL)
+        print_transposition_table_stats(context.table);
+    free(context.path);
+    free(context.movements);
+    return found;
+}
+
+/**
+ * Deepest level at which a parallel IDA* splits its tree into work items.
+ */
+#define MAX_SPLIT_DEPTH 8
+
+/**
+ * Number of work items a parallel IDA* aims for per thread, so that the
+ * threads done early have work left to steal.
+ */
+#define WORK_ITEMS_PER_THREAD 16
+
+/**
+ * @struct WorkItem
+ * @brief A subtree of a parallel IDA* search.
+ *
+ * path holds the packed states from the root of the search to the root of
+ * the subtree, movements the movements between them and costs their cost
+ * function values.
+ */
+typedef struct s_work_item {
+    PackedState path[MAX_SPLIT_DEPTH + 1];
+    Movement movements[MAX_SPLIT_DEPTH];
+    double costs[MAX_SPLIT_DEPTH + 1];
+    int depth;
+} WorkItem;
+
+/**
+ * @struct WorkDeque
+ * @brief The work items dealt to a thread, from top to bottom.
+ *
+ * The owner takes items from the bottom and the other threads steal them
+ * from the top. Items are only dealt between passes, so the deque never
+ * grows while it is shared and a lock per deque is enough.
+ */
+typedef struct s_work_deque {
+    int *items;
+    int top;
+    int bottom;
+    mtx_t lock;
+} WorkDeque;
+
+/**
+ * @struct Barrier
+ * @brief Reusable barrier of a fixed number of threads.
+ *
+ * generation counts the times the barrier opened, so that a thread waiting
+ * at it is only released by the last thread of its own round.
+ */
+typedef struct s_barrier {
+    mtx_t lock;
+    cnd_t opened;
+    int nb_threads;
+    int nb_waiting;
+    unsigned long long generation;
+} Barrier;
+
+static void init_barrier(Barrier *barrier, int nb_threads) {
+    mtx_init(&barrier->lock, mtx_plain);
+    cnd_init(&barrier->opened);
+    barrier->nb_threads = nb_threads;
+    barrier->nb_waiting = 0;
+    barrier->generation = 0;
+}
+
+static void destroy_barrier(Barrier *barrier) {
+    mtx_destroy(&barrier->lock);
+    cnd_destroy(&barrier->opened);
+}
+
+/**
+ * Waits until every thread of a barrier reached it. What a thread wrote
+ * before the barrier is visible to the others after it.
+ */
+static void wait_barrier(Barrier *barrier) {
+    mtx_lock(&barrier->lock);
+    unsigned long long generation = barrier->generation;
+    if (++barrier->nb_waiting == barrier->nb_threads) {
+        barrier->nb_waiting = 0;
+        barrier->generation++;
+        cnd_broadcast(&barrier->opened);
+    } else {
+        while (generation == barrier->generation) {
+            cnd_wait(&barrier->opened, &barrier->lock);
+        }
+    }
+    mtx_unlock(&barrier->lock);
+}
+
+/**
+ * @struct IdaStarWorker
+ * @brief A thread of a parallel IDA* search, with its own context and
+ * statistics.
+ *
+ * The transposition table of the thread is released when it exits, so it
+ * leaves the counters and number of states of the table in table_counters
+ * and table_size.
+ */
+typedef struct s_ida_star_worker {
+    struct s_parallel_ida_star *search;
+    int id;
+    thrd_t thread;
+    IdaStarContext context;
+    SearchStats stats;
+    double min_cost_exceeding_threshold;
+    long long steals;
+    TranspositionCounters table_counters;
+    unsigned long long table_size;
+} IdaStarWorker;
+
+/**
+ * @struct ParallelIdaStar
+ * @brief State of a parallel IDA* search shared by its threads.
+ *
+ * The threads live for the whole search. Each pass starts when the calling
+ * thread, having dealt the work items, joins them at the barrier, and ends
+ * when they all reach it again; finished tells them to return instead. found
+ * is set by the first thread reaching a goal state, which becomes the
+ * winner, and cancels the pass of the other threads.
+ */
+typedef struct s_parallel_ida_star {
+    WorkItem *items;
+    int nb_items;
+    WorkDeque *deques;
+    IdaStarWorker *workers;
+    int nb_threads;
+    double threshold;
+    Barrier barrier;
+    bool finished;
+    atomic_bool found;
+    IdaStarWorker *winner;
+} ParallelIdaStar;
+
+/**
+ * Splits the tree of a parallel IDA* search into work items, expanding it one
+ * level at a time until there are enough of them. The same duplicates as in
+ * ida_star_pass() are pruned. Returns false if a goal state was reached while
+ * splitting, the search being then left to the sequential IDA*.
+ */
+static bool split_ida_star_tree(ParallelIdaStar *search, State *current,
+                                int (*heuristic)(State), int step_cost) {
+    int nb_wanted = WORK_ITEMS_PER_THREAD * search->nb_threads;
+    Movement movements[MAX_MOVEMENTS];
+    WorkItem *layer = malloc(sizeof(WorkItem));
+    int nb_items = 1;
+    layer[0].depth = 0;
+    layer[0].path[0] = pack_state(current);
+    layer[0].costs[0] = packed_f(layer[0].path[0], 0, heuristic, step_cost);
+    bool goal_reached = is_packed_goal_state(layer[0].path[0]);
+    while (!goal_reached && nb_items < nb_wanted &&
+           layer[0].depth < MAX_SPLIT_DEPTH) {
+        WorkItem *next = malloc(nb_items * MAX_MOVEMENTS * sizeof(WorkItem));
+        int nb_next = 0;
+        for (int i = 0; i < nb_items; i++) {
+            WorkItem *item = &layer[i];
+            int depth = item->depth;
+            PackedState packed = item->path[depth];
+            int nb_movement = packed_possible_movements(packed, movements);
+            for (int j = 0; j < nb_movement; j++) {
+                Movement movement = movements[j];
+                if (depth > 0 &&
+                    movement.from == item->movements[depth - 1].to &&
+                    movement.to == item->movements[depth - 1].from)
+                    continue;
+                PackedState child =
+                    apply_movement_to_packed_state(packed, movement);
+                bool on_path = false;
+                for (int k = 0; k <= depth && !on_path; k++) {
+                    on_path = item->path[k] == child;
+                }
+                if (on_path)
+                    continue;
+                WorkItem *child_item = &next[nb_next++];
+                *child_item = *item;
+                child_item->depth = depth + 1;
+                child_item->path[depth + 1] = child;
+                child_item->movements[depth] = movement;
+                child_item->costs[depth + 1] =
+                    packed_f(child, depth + 1, heuristic, step_cost);
+                goal_reached = goal_reached || is_packed_goal_state(child);
+            }
+        }
+        free(layer);
+        layer = next;
+        nb_items = nb_next;
+    }
+    search->items = layer;
+    search->nb_items = nb_items;
+    return !goal_reached;
+}
+
+/**
+ * Deals the work items of a parallel IDA* search round-robin to the deques
+ * of its threads.
+ */
+static void deal_work_items(ParallelIdaStar *search) {
+    for (int i = 0; i < search->nb_threads; i++) {
+        search->deques[i].top = 0;
+        search->deques[i].bottom = 0;
+    }
+    for (int i = 0; i < search->nb_items; i++) {
+        WorkDeque *deque = &search->deques[i % search->nb_threads];
+        deque->items[deque->bottom++] = i;
+    }
+}
+
+/**
+ * Takes a work item from the bottom of the own deque of a worker or, once it
+ * is empty, steals one from the top of the deque of another worker. Returns
+ * false if every deque is empty.
+ */
+static bool take_work_item(ParallelIdaStar *search, IdaStarWorker *worker,
+                           int *item) {
+    for (int i = 0; i < search->nb_threads; i++) {
+        WorkDeque *deque =
+            &search->deques[(worker->id + i) % search->nb_threads];
+        mtx_lock(&deque->lock);
+        bool taken = deque->top < deque->bottom;
+        if (taken && i == 0)
+            *item = deque->items[--deque->bottom];
+        else if (taken)
+            *item = deque->items[deque->top++];
+        mtx_unlock(&deque->lock);
+        if (taken) {
+            worker->steals += i != 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Runs an IDA* pass over the subtree of a work item. The states above the
+ * subtree are bounded by the threshold as they would be in ida_star_pass().
+ */
+static double search_work_item(IdaStarWorker *worker, const WorkItem *item,
+                               double threshold) {
+    for (int i = 0; i <= item->depth; i++) {
+        if (item->costs[i] > threshold)
+            return item->costs[i];
+    }
+    IdaStarContext *context = &worker->context;
+    for (int i = 0; i <= item->depth; i++) {
+        context->path[i] = item->path[i];
+    }
+    for (int i = 0; i < item->depth; i++) {
+        context->movements[i] = item->movements[i];
+    }
+    unpack_state(item->path[item->depth], &context->state);
+    context->state.depth = item->depth;
+    return ida_star_pass(context, item->depth, threshold,
+                         item->costs[item->depth]);
+}
+
+/**
+ * Runs the passes of a worker of a parallel IDA* search, one per opening of
+ * the barrier, until the search is finished.
+ */
+static int run_ida_star_worker(void *argument) {
+    IdaStarWorker *worker = argument;
+    ParallelIdaStar *search = worker->search;
+    // Each thread has its own transposition table, kept across the passes
+    worker->context.table = ida_star_table();
+    while (true) {
+        wait_barrier(&search->barrier);
+        if (search->finished)
+            break;
+        // As in ida_star(), the states seen are those of the last pass
+        worker->context.nb_seen = 0;
+        worker->min_cost_exceeding_threshold = INT_MAX;
+        int item;
+        while (!atomic_load_explicit(&search->found, memory_order_relaxed) &&
+               take_work_item(search, worker, &item)) {
+            double result = search_work_item(worker, &search->items[item],
+                                             search->threshold);
+            if (result == IDA_STAR_FOUND) {
+                if (!atomic_exchange(&search->found, true))
+                    search->winner = worker;
+                break;
+            }
+            if (result < worker->min_cost_exceeding_threshold)
+                worker->min_cost_exceeding_threshold = result;
+        }
+        wait_barrier(&search->barrier);
+    }
+    if (worker->context.table != NULL) {
+        worker->table_counters = worker->context.table->counters;
+        worker->table_size = worker->context.table->size;
+        worker->context.table = NULL;
+    }
+    return 0;
+}
+
+bool parallel_ida_star(State *current, States *path, int (*heuristic)(State),
+                       int step_cost, int nb_threads, SearchStats *stats) {
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    ParallelIdaStar search = {.nb_threads = nb_threads > 0 ? nb_threads : 1};
+    atomic_init(&search.found, false);
+    if (!split_ida_star_tree(&search, current, heuristic, step_cost)) {
+        free(search.items);
+        return ida_star(current, path, heuristic, step_cost, stats);
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    search.deques = calloc(search.nb_threads, sizeof(WorkDeque));
+    search.workers = calloc(search.nb_threads, sizeof(IdaStarWorker));
+    for (int i = 0; i < search.nb_threads; i++) {
+        WorkDeque *deque = &search.deques[i];
+        deque->items =
+            malloc((search.nb_items / search.nb_threads + 1) * sizeof(int));
+        mtx_init(&deque->lock, mtx_plain);
+        IdaStarWorker *worker = &search.workers[i];
+        worker->search = &search;
+        worker->id = i;
+        init_search_stats(&worker->stats);
+        worker->context = (IdaStarContext){
+            .capacity = 64,
+            .step_cost = step_cost,
+            .stats = &worker->stats,
+            .cancelled = &search.found,
+        };
+        set_ida_star_heuristic(&worker->context, heuristic);
+        worker->context.path = malloc(64 * sizeof(PackedState));
+        worker->context.movements = malloc(64 * sizeof(Movement));
+    }
+
+    // The calling thread takes part in the barrier, to deal the work items
+    // between the passes
+    init_barrier(&search.barrier, search.nb_threads + 1);
+    search.finished = false;
+    for (int i = 0; i < search.nb_threads; i++) {
+        thrd_create(&search.workers[i].thread, run_ida_star_worker,
+                    &search.workers[i]);
+    }
+    search.threshold = search.items[0].costs[0];
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    while (true) {
+        STATS_ADD(stats, iterations, 1);
+        deal_work_items(&search);
+        wait_barrier(&search.barrier);
+        wait_barrier(&search.barrier);
+        double threshold = INT_MAX;
+        for (int i = 0; i < search.nb_threads; i++) {
+            if (search.workers[i].min_cost_exceeding_threshold < threshold)
+                threshold = search.workers[i].min_cost_exceeding_threshold;
+        }
+        if (atomic_load(&search.found) || threshold == INT_MAX)
+            break;
+        search.threshold = threshold;
+    }
+    search.finished = true;
+    wait_barrier(&search.barrier);
+    for (int i = 0; i < search.nb_threads; i++) {
+        thrd_join(search.workers[i].thread, NULL);
+    }
+    destroy_barrier(&search.barrier);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long long nb_nodes = 0;
+    long long nb_steals = 0;
+    TranspositionCounters counters = {0, 0, 0, 0};
+    unsigned long long nb_stored = 0;
+    bool has_table = ida_star_table_bytes > 0;
+    for (int i = 0; i < search.nb_threads; i++) {
+        IdaStarWorker *worker = &search.workers[i];
+        merge_search_stats(stats, &worker->stats, true);
+        STATS_ADD(stats, seen, worker->context.nb_seen);
+        nb_nodes += worker->context.nb_expanded;
+        nb_steals += worker->steals;
+        counters.hits += worker->table_counters.hits;
+        counters.misses += worker->table_counters.misses;
+        counters.stores += worker->table_counters.stores;
+        counters.replacements += worker->table_counters.replacements;
+        nb_stored += worker->table_size;
+    }
+    // Counted even without the statistics, for the node rate of the search
+    stats->expansions += nb_nodes;
+    bool found = atomic_load(&search.found);
+    if (found) {
+        STATS_PHASE(stats, SEARCH_PHASE_PATH);
+        IdaStarContext *winner = &search.winner->context;
+        build_packed_path(winner->path, winner->goal_depth, current, path);
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    double elapsed =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    search_printf("Parallel IDA*: %d threads, %d work items at depth %d, "
+                  "%lld steals\n",
+                  search.nb_threads, search.nb_items, search.items[0].depth,
+                  nb_steals);
+    search_printf("Expanded %lld nodes in %.3f s, %.0f nodes/s\n", nb_nodes,
+                  elapsed, elapsed > 0 ? nb_nodes / elapsed : 0.0);
+    if (has_table) {
+        unsigned long long probes = counters.hits + counters.misses;
+        search_printf(
+            "Transposition tables: %llu states, %d x %zu bytes, hit rate "
+            "%.2f, replacement rate %.2f\n",
+            nb_stored, search.nb_threads, ida_star_table_bytes,
+            probes > 0 ? (double)counters.hits / probes : 0.0,
+            counters.stores > 0
+                ? (double)counters.replacements / counters.stores
+                : 0.0);
+    }
+
+    for (int i = 0; i < search.nb_threads; i++) {
+        free(search.deques[i].items);
+        mtx_destroy(&search.deques[i].lock);
+        free(search.workers[i].context.path);
+        free(search.workers[i].context.movements);
+    }
+    free(search.deques);
+    free(search.workers);
+    free(search.items);
+    return found;
+}
+
+/**
+ * Number of low bits of an HDA* node reference holding the index of the node
+ * in the pool of its owner, the high bits holding the owner.
+ */
+#define HDA_STAR_NODE_BITS 24
+
+/**
+ * Defines the maximum number of threads of an HDA* search.
+ */
+#define HDA_STAR_MAX_THREADS (1 << (32 - HDA_STAR_NODE_BITS))
+
+/**
+ * Number of expansions after which an HDA* thread sends its partial blocks,
+ * so that the other threads are not kept waiting for them.
+ */
+#define HDA_STAR_FLUSH_INTERVAL 16
+
+/**
+ * @struct HdaStarWorker
+ * @brief A thread of an HDA* search, owning the states hashed to it.
+ *
+ * Its pool, open list and generated map only hold the states it owns. The
+ * states it generates for the other threads are gathered in one outbox block
+ * per owner, sent to the inbox of the owner once full.
+ */
+typedef struct s_hda_star_worker {
+    struct s_hda_star *search;
+    int id;
+    thrd_t thread;
+    NodePool pool;
+    PriorityQueue open;
+    StateMap generated;
+    MessageQueue inbox;
+    MessageBlock **outboxes;
+    SearchStats stats;
+    long long nb_expanded;
+    long long nb_sent;
+} HdaStarWorker;
+
+/**
+ * @struct HdaStar
+ * @brief State of an HDA* search shared by its threads.
+ *
+ * active counts the threads with work left plus the blocks sent and not yet
+ * taken by their owner. A thread only sends while it is active itself, so
+ * once active drops to 0 it stays there and the search is over. incumbent is
+ * the cost of the best goal state found so far and goal its node reference.
+ */
+typedef struct s_hda_star {
+    HdaStarWorker *workers;
+    int nb_threads;
+    int (*heuristic)(State);
+    int step_cost;
+    atomic_long active;
+    _Atomic double incumbent;
+    uint32_t goal;
+    mtx_t goal_lock;
+} HdaStar;
+
+static int hda_star_owner(const HdaStar *search, PackedState state) {
+    return hash_packed_state(state) % search->nb_threads;
+}
+
+static Node *get_hda_star_node(HdaStar *search, uint32_t reference) {
+    HdaStarWorker *owner = &search->workers[reference >> HDA_STAR_NODE_BITS];
+    return get_node(&owner->pool,
+                    reference & ((1u << HDA_STAR_NODE_BITS) - 1));
+}
+
+/**
+ * Adds a state to the open list of its owner, or lowers its depth if it was
+ * already generated deeper, reopening it if it was closed.
+ */
+static void receive_state(HdaStarWorker *worker, PackedState state,
+                          uint32_t parent, int depth) {
+    HdaStar *search = worker->search;
+    NodeId id;
+    if (!get_from_state_map(&worker->generated, state, &id)) {
+        id = new_node(&worker->pool, state, parent, depth);
+        assert(id < (1u << HDA_STAR_NODE_BITS) - 1);
+        put_in_state_map(&worker->generated, state, id);
+        insert_in_queue(
+            &worker->open, id,
+            packed_f(state, depth, search->heuristic, search->step_cost),
+            depth);
+        return;
+    }
+    Node *node = get_node(&worker->pool, id);
+    if (depth >= node->depth) {
+        STATS_ADD(&worker->stats, duplicates, 1);
+        return;
+    }
+    node->parent = parent;
+    node->depth = depth;
+    double cost = packed_f(state, depth, search->heuristic, search->step_cost);
+    if (is_node_in_queue(&worker->open, id))
+        decrease_priority(&worker->open, id, cost, depth);
+    else
+        insert_in_queue(&worker->open, id, cost, depth);
+}
+
+static void flush_outbox(HdaStarWorker *worker, int owner) {
+    MessageBlock *block = worker->outboxes[owner];
+    if (block == NULL)
+        return;
+    // The block keeps the search active until its owner takes it
+    atomic_fetch_add(&worker->search->active, 1);
+    push_message_block(&worker->search->workers[owner].inbox, block);
+    worker->outboxes[owner] = NULL;
+    worker->nb_sent += block->size;
+}
+
+static void flush_outboxes(HdaStarWorker *worker) {
+    for (int i = 0; i < worker->search->nb_threads; i++) {
+        flush_outbox(worker, i);
+    }
+}
+
+static void send_state(HdaStarWorker *worker, PackedState state,
+                       uint32_t parent, int depth) {
+    int owner = hda_star_owner(worker->search, state);
+    if (owner == worker->id) {
+        receive_state(worker, state, parent, depth);
+        return;
+    }
+    MessageBlock *block = worker->outboxes[owner];
+    if (block == NULL) {
+        block = malloc(sizeof(MessageBlock));
+        assert(block != NULL);
+        block->size = 0;
+        worker->outboxes[owner] = block;
+    }
+    block->messages[block->size++] = (StateMessage){state, parent, depth};
+    if (block->size == MESSAGE_BLOCK_SIZE)
+        flush_outbox(worker, owner);
+}
+
+static void expand_hda_star_node(HdaStarWorker *worker) {
+    HdaStar *search = worker->search;
+    NodeId id = pop_min_priority(&worker->open);
+    Node node = *get_node(&worker->pool, id);
+    STATS_ADD(&worker->stats, seen, 1);
+    uint32_t reference = id | (uint32_t)worker->id << HDA_STAR_NODE_BITS;
+    if (is_packed_goal_state(node.state)) {
+        double cost = packed_f(node.state, node.depth, search->heuristic,
+                               search->step_cost);
+        mtx_lock(&search->goal_lock);
+        if (cost < atomic_load(&search->incumbent)) {
+            atomic_store(&search->incumbent, cost);
+            search->goal = reference;
+        }
+        mtx_unlock(&search->goal_lock);
+        return;
+    }
+    worker->nb_expanded++;
+    Movement movements[MAX_MOVEMENTS];
+    int nb_movement = packed_possible_movements(node.state, movements);
+    for (int i = 0; i < nb_movement; i++) {
+        STATS_ADD(&worker->stats, generations, 1);
+        PackedState child =
+            apply_movement_to_packed_state(node.state, movements[i]);
+        send_state(worker, child, reference, node.depth + 1);
+    }
+    STATS_PEAK(&worker->stats, open_peak, worker->open.size);
+}
+
+static int run_hda_star_worker(void *argument) {
+    HdaStarWorker *worker = argument;
+    HdaStar *search = worker->search;
+    bool active = true;
+    int nb_expanded = 0;
+    while (true) {
+        MessageBlock *blocks = take_message_blocks(&worker->inbox);
+        if (blocks != NULL) {
+            long nb_blocks = 0;
+            for (MessageBlock *block = blocks; block; block = block->next) {
+                nb_blocks++;
+            }
+            // An idle thread turns the token of a block into its own
+            if (!active) {
+                active = true;
+                nb_blocks--;
+            }
+            atomic_fetch_sub(&search->active, nb_blocks);
+            while (blocks != NULL) {
+                MessageBlock *next = blocks->next;
+                for (int i = 0; i < blocks->size; i++) {
+                    StateMessage *message = &blocks->messages[i];
+                    receive_state(worker, message->state, message->parent,
+                                  message->depth);
+                }
+                free(blocks);
+                blocks = next;
+            }
+        }
+        // Nodes that cannot beat the incumbent are left in the open list
+        if (worker->open.size > 0 &&
+            min_priority(&worker->open) < atomic_load(&search->incumbent)) {
+            expand_hda_star_node(worker);
+            if (++nb_expanded % HDA_STAR_FLUSH_INTERVAL == 0)
+                flush_outboxes(worker);
+            continue;
+        }
+        flush_outboxes(worker);
+        if (active) {
+            active = false;
+            atomic_fetch_sub(&search->active, 1);
+        }
+        if (atomic_load(&search->active) == 0)
+            break;
+        thrd_yield();
+    }
+    return 0;
+}
+
+bool hda_star(State *current, States *path, int (*heuristic)(State),
+              int step_cost, int nb_threads, SearchStats *stats) {
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    if (nb_threads < 1)
+        nb_threads = 1;
+    if (nb_threads > HDA_STAR_MAX_THREADS)
+        nb_threads = HDA_STAR_MAX_THREADS;
+    HdaStar search = {
+        .nb_threads = nb_threads,
+        .heuristic = heuristic,
+        .step_cost = step_cost,
+        .goal = NO_PARENT,
+    };
+    atomic_init(&search.active, search.nb_threads);
+    atomic_init(&search.incumbent, INT_MAX);
+    mtx_init(&search.goal_lock, mtx_plain);
+    search.workers = calloc(search.nb_threads, sizeof(HdaStarWorker));
+    for (int i = 0; i < search.nb_threads; i++) {
+        HdaStarWorker *worker = &search.workers[i];
+        worker->search = &search;
+        worker->id = i;
+        init_node_pool(&worker->pool);
+        init_priority_queue(&worker->open);
+        init_state_map(&worker->generated);
+        init_message_queue(&worker->inbox);
+        worker->outboxes = calloc(search.nb_threads, sizeof(MessageBlock *));
+        init_search_stats(&worker->stats);
+    }
+    PackedState root = pack_state(current);
+    receive_state(&search.workers[hda_star_owner(&search, root)], root,
+                  NO_PARENT, 0);
+
+    struct timespec start, end;
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < search.nb_threads; i++) {
+        thrd_create(&search.workers[i].thread, run_hda_star_worker,
+                    &search.workers[i]);
+    }
+    for (int i = 0; i < search.nb_threads; i++) {
+        thrd_join(search.workers[i].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    long long nb_nodes = 0;
+    long long nb_sent = 0;
+    unsigned long long nb_generated = 0;
+    for (int i = 0; i < search.nb_threads; i++) {
+        HdaStarWorker *worker = &search.workers[i];
+        STATS_PEAK(&worker->stats, closed_peak,
+                   worker->generated.size - worker->open.size);
+        merge_search_stats(stats, &worker->stats, true);
+        nb_nodes += worker->nb_expanded;
+        nb_sent += worker->nb_sent;
+        nb_generated += worker->generated.size;
+    }
+    // Counted even without the statistics, for the node rate of the search
+    stats->expansions += nb_nodes;
+    bool found = search.goal != NO_PARENT;
+    if (found) {
+        STATS_PHASE(stats, SEARCH_PHASE_PATH);
+        Node *node = get_hda_star_node(&search, search.goal);
+        unpack_state(node->state, current);
+        current->depth = node->depth;
+        reserve_states(path, path->size + node->depth);
+        while (node->parent != NO_PARENT) {
+            State state;
+            unpack_state(node->state, &state);
+            state.depth = node->depth;
+            push_state(path, &state);
+            node = get_hda_star_node(&search, node->parent);
+        }
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    double elapsed =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    search_printf("HDA*: %d threads, %llu states generated, %lld sent to "
+                  "another thread\n",
+                  search.nb_threads, nb_generated, nb_sent);
+    search_printf("Expanded %lld nodes in %.3f s, %.0f nodes/s\n", nb_nodes,
+                  elapsed, elapsed > 0 ? nb_nodes / elapsed : 0.0);
+    if (!found)
+        search_printf("Goal state not found!\n");
+
+    for (int i = 0; i < search.nb_threads; i++) {
+        HdaStarWorker *worker = &search.workers[i];
+        free_node_pool(&worker->pool);
+        free_priority_queue(&worker->open);
+        free_state_map(&worker->generated);
+        free(worker->outboxes);
+    }
+    free(search.workers);
+    mtx_destroy(&search.goal_lock);
+    return found;
+}
+
+bool breadth_first_search(State *current, States *path, SearchStats *stats) {
+    NodePool pool;
+    StateBitset visited;
+    Movement movements[MAX_MOVEMENTS];
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    init_node_pool(&pool);
+    init_state_bitset(&visited);
+    // The nodes hold canonical states, whose columns the path is relabelled
+    // back to
+    PackedState root = canonical_packed_state(pack_state(current));
+    NodeId goal = new_node(&pool, root, NO_PARENT, 0);
+    add_index_to_bitset(&visited, packed_state_index(root));
+    bool found = is_packed_goal_state(root);
+    // The pool holds the nodes in the order they are generated, so it is
+    // also the FIFO queue of the search
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    for (NodeId next = 0; !found && next < pool.size; next++) {
+        Node node = *get_node(&pool, next);
+        STATS_ADD(stats, seen, 1);
+        STATS_ADD(stats, expansions, 1);
+        int nb_movement = packed_possible_movements(node.state, movements);
+        for (int i = 0; i < nb_movement && !found; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child = canonical_packed_state(
+                apply_movement_to_packed_state(node.state, movements[i]));
+            if (!add_index_to_bitset(&visited, packed_state_index(child))) {
+                STATS_ADD(stats, duplicates, 1);
+                continue;
+            }
+            goal = new_node(&pool, child, next, node.depth + 1);
+            found = is_packed_goal_state(child);
+        }
+        STATS_PEAK(stats, open_peak, pool.size - next - 1);
+    }
+    STATS_PEAK(stats, closed_peak, visited.size);
+    if (found) {
+        search_printf("Goal state found on depth %d!\n",
+                      get_node(&pool, goal)->depth);
+        print_visited_set_stats(&visited);
+        STATS_PHASE(stats, SEARCH_PHASE_PATH);
+        build_canonical_path(&pool, goal, current, path);
+    } else {
+        search_printf("Goal state not found!\n");
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free_node_pool(&pool);
+    free_state_bitset(&visited);
+    return found;
+}
+
+/**
+ * @struct SearchSide
+ * @brief One direction of a bidirectional search.
+ *
+ * The nodes of the current layer are pool->nodes[layer_start] onwards, and
+ * seen maps every state reached in this direction to its node.
+ */
+typedef struct s_search_side {
+    NodePool pool;
+    StateMap seen;
+    unsigned long long layer_start;
+} SearchSide;
+
+static void init_search_side(SearchSide *side) {
+    init_node_pool(&side->pool);
+    init_state_map(&side->seen);
+    side->layer_start = 0;
+}
+
+static void free_search_side(SearchSide *side) {
+    free_node_pool(&side->pool);
+    free_state_map(&side->seen);
+}
+
+/**
+ * Adds a state to a side, unless the side already reached it. Returns true
+ * if the state was added.
+ */
+static bool add_to_search_side(SearchSide *side, PackedState state,
+                               NodeId parent, int depth) {
+    uint32_t id;
+    if (get_from_state_map(&side->seen, state, &id))
+        return false;
+    put_in_state_map(&side->seen, state,
+                     new_node(&side->pool, state, parent, depth));
+    return true;
+}
+
+/**
+ * Expands the current layer of side, looking for its successors in other.
+ * On a meeting, the nodes of side and other on both ends of the shortest
+ * meeting movement are stored in meeting.
+ */
+static bool expand_layer(SearchSide *side, SearchSide *other,
+                         NodeId meeting[2], SearchStats *stats) {
+    Movement movements[MAX_MOVEMENTS];
+    unsigned long long layer_end = side->pool.size;
+    int best_length = INT_MAX;
+    for (NodeId next = side->layer_start; next < layer_end; next++) {
+        Node node = *get_node(&side->pool, next);
+        STATS_ADD(stats, seen, 1);
+        STATS_ADD(stats, expansions, 1);
+        int nb_movement = packed_possible_movements(node.state, movements);
+        for (int i = 0; i < nb_movement; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child = canonical_packed_state(
+                apply_movement_to_packed_state(node.state, movements[i]));
+            uint32_t other_id;
+            if (get_from_state_map(&other->seen, child, &other_id)) {
+                int length =
+                    node.depth + 1 + get_node(&other->pool, other_id)->depth;
+                if (length < best_length) {
+                    best_length = length;
+                    meeting[0] = next;
+                    meeting[1] = other_id;
+                }
+            } else if (!add_to_search_side(side, child, next,
+                                           node.depth + 1)) {
+                STATS_ADD(stats, duplicates, 1);
+            }
+        }
+    }
+    STATS_PEAK(stats, open_peak, side->pool.size - layer_end);
+    side->layer_start = layer_end;
+    return best_length != INT_MAX;
+}
+
+bool bidirectional_search(State *current, States *path, SearchStats *stats) {
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    SearchSide forward, backward;
+    init_search_side(&forward);
+    init_search_side(&backward);
+    // Both sides search over canonical states, the goals sharing a single one
+    PackedState root = canonical_packed_state(pack_state(current));
+    add_to_search_side(&forward, root, NO_PARENT, 0);
+    int nb_goal;
+    PackedState *goals = packed_goal_states(&nb_goal);
+    for (int i = 0; i < nb_goal; i++) {
+        add_to_search_side(&backward, canonical_packed_state(goals[i]),
+                           NO_PARENT, 0);
+    }
+    free(goals);
+
+    // The path goes from the root to forward_end, then, one movement later
+    // or on the same state when gap is 0, from backward_end to a goal
+    NodeId meeting[2], forward_end = 0, backward_end = 0;
+    int gap = 1;
+    bool found = get_from_state_map(&backward.seen, root, &backward_end);
+    if (found)
+        gap = 0;
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    while (!found && forward.layer_start < forward.pool.size &&
+           backward.layer_start < backward.pool.size) {
+        if (forward.pool.size - forward.layer_start <=
+            backward.pool.size - backward.layer_start) {
+            found = expand_layer(&forward, &backward, meeting, stats);
+            forward_end = meeting[0];
+            backward_end = meeting[1];
+        } else {
+            found = expand_layer(&backward, &forward, meeting, stats);
+            forward_end = meeting[1];
+            backward_end = meeting[0];
+        }
+    }
+
+    if (found) {
+        int forward_depth = get_node(&forward.pool, forward_end)->depth;
+        int backward_depth = get_node(&backward.pool, backward_end)->depth;
+        int length = forward_depth + gap + backward_depth;
+        search_printf("Goal state found on depth %d!\n", length);
+        search_printf("Forward: %llu states, backward: %llu states\n",
+                      forward.seen.size, backward.seen.size);
+        STATS_PHASE(stats, SEARCH_PHASE_PATH);
+
+        // Lay the path out from the root to the goal
+        PackedState *states = malloc((length + 1) * sizeof(PackedState));
+        NodeId id = forward_end;
+        for (int i = forward_depth; i >= 0; i--) {
+            states[i] = get_node(&forward.pool, id)->state;
+            id = get_node(&forward.pool, id)->parent;
+        }
+        int i = forward_depth + gap;
+        for (id = backward_end; id != NO_PARENT;
+             id = get_node(&backward.pool, id)->parent) {
+            states[i++] = get_node(&backward.pool, id)->state;
+        }
+        states[0] = pack_state(current);
+        relabel_canonical_path(states, length);
+        build_packed_path(states, length, current, path);
+        free(states);
+    } else {
+        search_printf("Goal state not found!\n");
+    }
+    STATS_PEAK(stats, closed_peak, forward.seen.size + backward.seen.size);
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free_search_side(&forward);
+    free_search_side(&backward);
+    return found;
+}
+
+/**
+ * Number of states an external breadth first search sorts in memory at once,
+ * the size of the runs it writes to disk.
+ */
+#define EXTERNAL_RUN_STATES (1 << 20)
+
+/**
+ * Number of states read or written at once from the files of an external
+ * breadth first search.
+ */
+#define EXTERNAL_BLOCK_STATES (1 << 13)
+
+/**
+ * @struct ExternalIo
+ * @brief Bytes read from and written to the disk by an external breadth
+ * first search.
+ */
+typedef struct s_external_io {
+    unsigned long long bytes_read;
+    unsigned long long bytes_written;
+} ExternalIo;
+
+/**
+ * @struct StateFile
+ * @brief Temporary file of packed states, written then read sequentially
+ * one block at a time.
+ *
+ * When writing, block holds the next states not written yet. When reading,
+ * it holds size states, next being the next one to read. The I/O is added
+ * to io.
+ */
+typedef struct s_state_file {
+    FILE *file;
+    PackedState *block;
+    size_t size;
+    size_t next;
+    bool writing;
+    unsigned long long nb_states;
+    ExternalIo *io;
+} StateFile;
+
+static void open_state_file(StateFile *file, ExternalIo *io) {
+    file->file = tmpfile();
+    assert(file->file != NULL);
+    file->block = malloc(EXTERNAL_BLOCK_STATES * sizeof(PackedState));
+    assert(file->block != NULL);
+    file->size = 0;
+    file->next = 0;
+    file->writing = true;
+    file->nb_states = 0;
+    file->io = io;
+}
+
+static void close_state_file(StateFile *file) {
+    fclose(file->file);
+    free(file->block);
+}
+
+static void flush_state_file(StateFile *file) {
+    size_t written =
+        fwrite(file->block, sizeof(PackedState), file->next, file->file);
+    assert(written == file->next);
+    file->io->bytes_written += written * sizeof(PackedState);
+    file->next = 0;
+}
+
+static void write_to_state_file(StateFile *file, PackedState state) {
+    file->block[file->next++] = state;
+    file->nb_states++;
+    if (file->next == EXTERNAL_BLOCK_STATES)
+        flush_state_file(file);
+}
+
+/**
+ * Flushes the states written to a file, if any, and starts reading it from
+ * its first state.
+ */
+static void rewind_state_file(StateFile *file) {
+    if (file->writing)
+        flush_state_file(file);
+    rewind(file->file);
+    file->writing = false;
+    file->size = 0;
+    file->next = 0;
+}
+
+static bool read_from_state_file(StateFile *file, PackedState *state) {
+    if (file->next == file->size) {
+        file->size = fread(file->block, sizeof(PackedState),
+                           EXTERNAL_BLOCK_STATES, file->file);
+        file->io->bytes_read += file->size * sizeof(PackedState);
+        file->next = 0;
+        if (file->size == 0)
+            return false;
+    }
+    *state = file->block[file->next++];
+    return true;
+}
+
+static int compare_packed_states(const void *a, const void *b) {
+    PackedState x = *(const PackedState *)a;
+    PackedState y = *(const PackedState *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @struct RunReader
+ * @brief Sequential reader of a run stored in the file of the runs of a
+ * layer, through a block of its own.
+ *
+ * offset is the position of the next states of the run in the file, and
+ * remaining their number.
+ */
+typedef struct s_run_reader {
+    PackedState *block;
+    size_t size;
+    size_t next;
+    long offset;
+    unsigned long long remaining;
+} RunReader;
+
+/**
+ * @struct ExternalRuns
+ * @brief The sorted runs of the successors of a layer, written one after
+ * the other to a single file, and the buffer of the successors not written
+ * to a run yet.
+ *
+ * Run i holds the states from index starts[i] to starts[i + 1] of the file,
+ * the last one ending with the file.
+ */
+typedef struct s_external_runs {
+    StateFile file;
+    unsigned long long *starts;
+    int nb_run;
+    int capacity;
+    PackedState *buffer;
+    size_t size;
+} ExternalRuns;
+
+/**
+ * Sorts the successors of the buffer and writes them without duplicates to
+ * a new run.
+ */
+static void flush_external_runs(ExternalRuns *runs) {
+    if (runs->size == 0)
+        return;
+    if (runs->nb_run == runs->capacity) {
+        runs->capacity *= 2;
+        runs->starts = realloc(runs->starts,
+                               runs->capacity * sizeof(unsigned long long));
+        assert(runs->starts != NULL);
+    }
+    runs->starts[runs->nb_run++] = runs->file.nb_states;
+    qsort(runs->buffer, runs->size, sizeof(PackedState),
+          compare_packed_states);
+    for (size_t i = 0; i < runs->size; i++) {
+        if (i == 0 || runs->buffer[i] != runs->buffer[i - 1])
+            write_to_state_file(&runs->file, runs->buffer[i]);
+    }
+    runs->size = 0;
+}
+
+static bool read_from_run(StateFile *file, RunReader *run,
+                          PackedState *state) {
+    if (run->next == run->size) {
+        if (run->remaining == 0)
+            return false;
+        size_t size = run->remaining < EXTERNAL_BLOCK_STATES
+                          ? run->remaining
+                          : EXTERNAL_BLOCK_STATES;
+        fseek(file->file, run->offset, SEEK_SET);
+        run->size = fread(run->block, sizeof(PackedState), size, file->file);
+        assert(run->size == size);
+        file->io->bytes_read += size * sizeof(PackedState);
+        run->offset += size * sizeof(PackedState);
+        run->remaining -= size;
+        run->next = 0;
+    }
+    *state = run->block[run->next++];
+    return true;
+}
+
+/**
+ * @struct RunHeap
+ * @brief Binary min-heap of the runs of a layer, by their next state, for
+ * the merge.
+ */
+typedef struct s_run_heap {
+    StateFile *file;
+    RunReader *runs;
+    PackedState *heads;
+    int *order;
+    int size;
+} RunHeap;
+
+static void sift_down_run(RunHeap *heap, int i) {
+    for (;;) {
+        int smallest = i;
+        for (int child = 2 * i + 1; child <= 2 * i + 2; child++) {
+            if (child < heap->size && heap->heads[heap->order[child]] <
+                                          heap->heads[heap->order[smallest]])
+                smallest = child;
+        }
+        if (smallest == i)
+            return;
+        int swap = heap->order[i];
+        heap->order[i] = heap->order[smallest];
+        heap->order[smallest] = swap;
+        i = smallest;
+    }
+}
+
+/**
+ * Pops the smallest state of the runs of a heap, reading the next state of
+ * its run.
+ */
+static PackedState pop_run_heap(RunHeap *heap) {
+    int run = heap->order[0];
+    PackedState state = heap->heads[run];
+    if (!read_from_run(heap->file, &heap->runs[run], &heap->heads[run]))
+        heap->order[0] = heap->order[--heap->size];
+    sift_down_run(heap, 0);
+    return state;
+}
+
+/**
+ * Checks if a state is in a sorted file read in increasing order of the
+ * states checked, head being the next state of the file, 0 past its end.
+ */
+static bool is_in_sorted_file(StateFile *file, PackedState *head,
+                              PackedState state) {
+    while (*head != 0 && *head < state) {
+        if (!read_from_state_file(file, head))
+            *head = 0;
+    }
+    return *head == state;
+}
+
+/**
+ * Merges the sorted runs of the successors of a layer into the next layer,
+ * dropping the duplicates within the runs and the states of the previous
+ * two layers, the only ones a successor can belong to with reversible
+ * movements. The merge stops at the first goal state, which is then stored
+ * in goal.
+ */
+static bool merge_runs(ExternalRuns *runs, StateFile *previous[2],
+                       StateFile *layer, PackedState *goal,
+                       SearchStats *stats) {
+    int nb_run = runs->nb_run;
+    flush_state_file(&runs->file);
+    RunHeap heap = {
+        .file = &runs->file,
+        .runs = malloc(nb_run * sizeof(RunReader)),
+        .heads = malloc(nb_run * sizeof(PackedState)),
+        .order = malloc(nb_run * sizeof(int)),
+        .size = 0,
+    };
+    assert(heap.runs != NULL && heap.heads != NULL && heap.order != NULL);
+    for (int i = 0; i < nb_run; i++) {
+        unsigned long long end =
+            i + 1 < nb_run ? runs->starts[i + 1] : runs->file.nb_states;
+        unsigned long long length = end - runs->starts[i];
+        heap.runs[i] = (RunReader){
+            .block = malloc((length < EXTERNAL_BLOCK_STATES
+                                 ? length
+                                 : EXTERNAL_BLOCK_STATES) *
+                            sizeof(PackedState)),
+            .size = 0,
+            .next = 0,
+            .offset = runs->starts[i] * sizeof(PackedState),
+            .remaining = length,
+        };
+        assert(heap.runs[i].block != NULL);
+        if (read_from_run(heap.file, &heap.runs[i], &heap.heads[i]))
+            heap.order[heap.size++] = i;
+    }
+    for (int i = heap.size / 2 - 1; i >= 0; i--) {
+        sift_down_run(&heap, i);
+    }
+    PackedState heads[2] = {0, 0};
+    for (int i = 0; i < 2; i++) {
+        if (previous[i] != NULL) {
+            rewind_state_file(previous[i]);
+            if (!read_from_state_file(previous[i], &heads[i]))
+                heads[i] = 0;
+        }
+    }
+
+    bool found = false;
+    PackedState last = 0;
+    while (heap.size > 0 && !found) {
+        PackedState state = pop_run_heap(&heap);
+        if (state == last)
+            continue;
+        last = state;
+        if ((previous[0] != NULL &&
+             is_in_sorted_file(previous[0], &heads[0], state)) ||
+            (previous[1] != NULL &&
+             is_in_sorted_file(previous[1], &heads[1], state))) {
+            STATS_ADD(stats, duplicates, 1);
+            continue;
+        }
+        write_to_state_file(layer, state);
+        found = is_packed_goal_state(state);
+        if (found)
+            *goal = state;
+    }
+    for (int i = 0; i < nb_run; i++) {
+        free(heap.runs[i].block);
+    }
+    free(heap.runs);
+    free(heap.heads);
+    free(heap.order);
+    return found;
+}
+
+/**
+ * Expands a layer into the next one, the successors being sorted in runs of
+ * up to EXTERNAL_RUN_STATES states written to disk, then merged.
+ */
+static bool expand_external_layer(StateFile *layers, int depth,
+                                  PackedState *buffer, ExternalIo *io,
+                                  PackedState *goal, SearchStats *stats) {
+    ExternalRuns runs = {
+        .starts = malloc(8 * sizeof(unsigned long long)),
+        .nb_run = 0,
+        .capacity = 8,
+        .buffer = buffer,
+        .size = 0,
+    };
+    assert(runs.starts != NULL);
+    open_state_file(&runs.file, io);
+    PackedState state;
+    rewind_state_file(&layers[depth]);
+    while (read_from_state_file(&layers[depth], &state)) {
+        STATS_ADD(stats, seen, 1);
+        STATS_ADD(stats, expansions, 1);
+        // Flush before a state whose successors would not fit
+        if (runs.size + MAX_MOVEMENTS > EXTERNAL_RUN_STATES)
+            flush_external_runs(&runs);
+        const HeightMoves *moves = height_moves(height_signature(state));
+        for (int i = 0; i < moves->nb_movement; i++) {
+            STATS_ADD(stats, generations, 1);
+            runs.buffer[runs.size++] = canonical_packed_state(
+                apply_movement_to_packed_state(state, moves->movements[i]));
+        }
+    }
+    flush_external_runs(&runs);
+
+    StateFile *previous[2] = {&layers[depth],
+                              depth > 0 ? &layers[depth - 1] : NULL};
+    open_state_file(&layers[depth + 1], io);
+    bool found = merge_runs(&runs, previous, &layers[depth + 1], goal, stats);
+    close_state_file(&runs.file);
+    free(runs.starts);
+    search_printf("Layer %d: %llu states from %d runs, %llu bytes written, "
+                  "%llu bytes read\n",
+                  depth + 1, layers[depth + 1].nb_states, runs.nb_run,
+                  io->bytes_written, io->bytes_read);
+    return found;
+}
+
+/**
+ * Finds a state of a layer file one movement away from a canonical state.
+ */
+static PackedState find_external_parent(StateFile *layer, PackedState state) {
+    PackedState neighbours[MAX_MOVEMENTS];
+    const HeightMoves *moves = height_moves(height_signature(state));
+    for (int i = 0; i < moves->nb_movement; i++) {
+        neighbours[i] = canonical_packed_state(
+            apply_movement_to_packed_state(state, moves->movements[i]));
+    }
+    PackedState parent;
+    rewind_state_file(layer);
+    while (read_from_state_file(layer, &parent)) {
+        for (int i = 0; i < moves->nb_movement; i++) {
+            if (neighbours[i] == parent)
+                return parent;
+        }
+    }
+    assert(false);
+    return 0;
+}
+
+bool external_breadth_first_search(State *current, States *path,
+                                   SearchStats *stats) {
+    STATS_PHASE(stats, SEARCH_PHASE_SETUP);
+    int layer_capacity = 32;
+    StateFile *layers = malloc(layer_capacity * sizeof(StateFile));
+    PackedState *buffer = malloc(EXTERNAL_RUN_STATES * sizeof(PackedState));
+    assert(layers != NULL && buffer != NULL);
+    // Every file adds its I/O to io, which is reset for each layer
+    ExternalIo io = {0, 0}, total = {0, 0};
+    PackedState goal = canonical_packed_state(pack_state(current));
+    open_state_file(&layers[0], &io);
+    write_to_state_file(&layers[0], goal);
+    int depth = 0;
+    bool found = is_packed_goal_state(goal);
+
+    // Each layer is a sorted file on disk, only the run being sorted and one
+    // block per open file staying in memory
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    while (!found && layers[depth].nb_states > 0) {
+        if (depth + 2 > layer_capacity) {
+            layer_capacity *= 2;
+            layers = realloc(layers, layer_capacity * sizeof(StateFile));
+            assert(layers != NULL);
+        }
+        io = (ExternalIo){0, 0};
+        found = expand_external_layer(layers, depth, buffer, &io, &goal,
+                                      stats);
+        depth++;
+        total.bytes_read += io.bytes_read;
+        total.bytes_written += io.bytes_written;
+        unsigned long long closed = layers[depth].nb_states +
+                                    layers[depth - 1].nb_states +
+                                    (depth > 1 ? layers[depth - 2].nb_states
+                                               : 0);
+        STATS_PEAK(stats, open_peak, layers[depth].nb_states);
+        STATS_PEAK(stats, closed_peak, closed);
+    }
+
+    if (found) {
+        search_printf("Goal state found on depth %d!\n", depth);
+        search_printf("External memory: %llu bytes written, %llu bytes "
+                      "read\n",
+                      total.bytes_written, total.bytes_read);
+        STATS_PHASE(stats, SEARCH_PHASE_PATH);
+        PackedState *states = malloc((depth + 1) * sizeof(PackedState));
+        assert(states != NULL);
+        states[depth] = goal;
+        for (int i = depth - 1; i > 0; i--) {
+            states[i] = find_external_parent(&layers[i], states[i + 1]);
+        }
+        states[0] = pack_state(current);
+        relabel_canonical_path(states, depth);
+        build_packed_path(states, depth, current, path);
+        free(states);
+    } else {
+        search_printf("Goal state not found!\n");
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    for (int i = 0; i <= depth; i++) {
+        close_state_file(&layers[i]);
+    }
+    free(layers);
+    free(buffer);
+    return found;
+}
@@ -8,32 +8,53 @@
 
 #ifndef ALGORITHMS_H
 #define ALGORITHMS_H
+#include "search_stats.h"
 #include "state.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
 /*-----------------------------------------------------------------*/
 
+/**
+ * Sets the stream the searches run by the calling thread print their
+ * progress to.
+ *
+ * @param stream The stream, or NULL for stdout.
+ */
+void set_search_output(FILE *stream);
+
+/**
+ * Sets the memory of the transposition table of the IDA* searches, in bytes.
+ * Each thread allocates its table on its first IDA* search and reuses it for
+ * the next ones, so the size is to be set before any search. The threads of
+ * a parallel IDA* search have a table each, for the time of the search.
+ *
+ * @param bytes The memory of the table, or 0 to search without one.
+ */
+void set_ida_star_table_size(size_t bytes);
+
 /**
  * Depth First Search algorithm.
  *
  * @param current The current state.
  * @param path The path to the goal state.
- * @param infos The number of seen states, created states and iterations.
+ * @param stats The statistics of the search, added to.
  * @return True if the goal state is found, false otherwise.
  */
-bool depth_first_search(State *current, States *path, int **infos);
+bool depth_first_search(State *current, States *path, SearchStats *stats);
 /**
  * Depth First Search algorithm with a maximum depth.
  *
  * @param current The current state.
  * @param path The path to the goal state.
  * @param depth_max The maximum depth to search.
- * @param infos The number of seen states, created states and iterations.
+ * @param stats The statistics of the search, added to.
  * @return True if the goal state is found within the maximum depth, false
  * otherwise.
  */
 bool depth_first_search_capped(State *current, States *path, int depth_max,
-                               int **infos);
+                               SearchStats *stats);
 
 /**
  * Iterative Deepening algorithm.
@@ -42,7 +63,7 @@ bool depth_first_search_capped(State *current, States *path, int depth_max,
  * @param path The path to the goal state.
  * @return True if the goal state is found, false otherwise.
  */
-bool iterative_deepening(State *current, States *path, int **infos);
+bool iterative_deepening(State *current, States *path, SearchStats *stats);
 
 /**
  * Calculate the number of misplaced cubes in the state.
@@ -52,6 +73,19 @@ bool iterative_deepening(State *current, States *path, int **infos);
  */
 int misplaced_cubes(State state);
 
+/**
+ * Calculate the change of the number of misplaced cubes made by a movement,
+ * from the two columns of the movement only.
+ *
+ * @param state The packed state before the movement.
+ * @param successor The packed state after the movement.
+ * @param movement The movement.
+ * @return The number of misplaced cubes of the successor minus that of the
+ * state.
+ */
+int misplaced_cubes_delta(PackedState state, PackedState successor,
+                          Movement movement);
+
 /**
  * Calculate the Manhattan distance of the state.
  *
@@ -60,6 +94,31 @@ int misplaced_cubes(State state);
  */
 int manhattan_distance(State state);
 
+/**
+ * Calculate the change of the Manhattan distance made by a movement, from
+ * the two columns of the movement only.
+ *
+ * @param state The packed state before the movement.
+ * @param successor The packed state after the movement.
+ * @param movement The movement.
+ * @return The Manhattan distance of the successor minus that of the state.
+ */
+int manhattan_distance_delta(PackedState state, PackedState successor,
+                             Movement movement);
+
+/**
+ * Calculate the Manhattan distance of every successor of a state at once.
+ *
+ * @param state The state to expand.
+ * @param movements The movements leading to the successors.
+ * @param nb_movement The number of movements.
+ * @param distances The Manhattan distance of each successor, in the order
+ * of the movements.
+ */
+void manhattan_distance_of_successors(const State *state,
+                                      const Movement movements[],
+                                      int nb_movement, int distances[]);
+
 /**
  * Calculate the cost function value for a state.
  *
@@ -78,13 +137,13 @@ double f(State state, int (*heuristic)(State), int step_cost);
  * @param threshold The threshold value for the heuristic function.
  * @param heuristic The heuristic function.
  * @param step_cost The cost of each step.
- * @param infos The number of seen states, created states and iterations.
+ * @param stats The statistics of the search, added to.
  * @return The minimum cost exceeding the threshold.
  */
 double depth_first_search_capped_heuristic(State *current, States *path,
                                            double threshold,
                                            int (*heuristic)(State),
-                                           int step_cost, int **infos);
+                                           int step_cost, SearchStats *stats);
 /**
  * Iterative Deepening algorithm with a heuristic function.
  *
@@ -92,11 +151,139 @@ double depth_first_search_capped_heuristic(State *current, States *path,
  * @param path The path to the goal state.
  * @param heuristic The heuristic function.
  * @param step_cost The cost of each step.
- * @param infos The number of seen states, created states and iterations.
+ * @param stats The statistics of the search, added to.
  * @return True if the goal state is found, false otherwise.
  */
 bool iterative_deepening_with_heuristic(State *current, States *path,
                                         int (*heuristic)(State), int step_cost,
-                                        int **infos);
+                                        SearchStats *stats);
+
+/**
+ * A* algorithm.
+ *
+ * Expands states by increasing cost function value, keeping the open states
+ * in an indexed priority queue and every generated state in a hash map, so
+ * that a cheaper path to an open state lowers its priority in place.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param heuristic The heuristic function.
+ * @param step_cost The cost of each step.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool a_star(State *current, States *path, int (*heuristic)(State),
+            int step_cost, SearchStats *stats);
+
+/**
+ * IDA* algorithm.
+ *
+ * Runs depth first passes bounded by the cost function value, applying and
+ * undoing movements on a single state. Duplicates are only pruned along the
+ * current path, so memory grows with the depth of the search alone. With a
+ * transposition table, see set_ida_star_table_size(), the cost bound learned
+ * from the subtree of each node is stored and prunes the revisits of the
+ * node, in the same pass or the next ones, within a fixed memory. The states
+ * differing only by the order of their columns share their bound, unless the
+ * heuristic tells them apart like the Manhattan distance.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param heuristic The heuristic function.
+ * @param step_cost The cost of each step.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool ida_star(State *current, States *path, int (*heuristic)(State),
+              int step_cost, SearchStats *stats);
+
+/**
+ * Parallel IDA* algorithm.
+ *
+ * Splits the tree into subtrees a few levels below the root, then runs every
+ * pass of IDA* over the subtrees on a pool of threads. Each thread owns a
+ * deque of subtrees and steals from the others once its own is empty. The
+ * first thread to reach a goal state stops the others. The nodes expanded per
+ * second are reported at the end of the search.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param heuristic The heuristic function.
+ * @param step_cost The cost of each step.
+ * @param nb_threads The number of threads.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool parallel_ida_star(State *current, States *path, int (*heuristic)(State),
+                       int step_cost, int nb_threads, SearchStats *stats);
+
+/**
+ * Hash Distributed A* (HDA*) algorithm.
+ *
+ * Runs A* on a pool of threads, each owning the open and closed states whose
+ * hash maps to it. The successors of a state are sent to their owner in
+ * blocks, through a lock-free queue per thread. A thread that reaches a goal
+ * state only bounds the search, which ends once no thread has a state cheaper
+ * than the best goal left and no block is in flight. Closed states reached
+ * again by a shorter path are reopened, so the path found is a shortest one
+ * for an admissible heuristic such as the pattern database.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param heuristic The heuristic function.
+ * @param step_cost The cost of each step.
+ * @param nb_threads The number of threads.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool hda_star(State *current, States *path, int (*heuristic)(State),
+              int step_cost, int nb_threads, SearchStats *stats);
+
+/**
+ * Breadth First Search algorithm.
+ *
+ * Expands the states layer by layer, so the path found is a shortest one.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool breadth_first_search(State *current, States *path, SearchStats *stats);
+
+/**
+ * Bidirectional Breadth First Search algorithm.
+ *
+ * Runs a forward search from the current state and a backward search from
+ * every goal state, expanding one full layer of the smaller frontier at a
+ * time, until they meet. Movements are reversible, so the backward search
+ * uses the same successors as the forward one. The path found is a shortest
+ * one.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool bidirectional_search(State *current, States *path, SearchStats *stats);
+
+/**
+ * External memory Breadth First Search algorithm.
+ *
+ * Expands the canonical states layer by layer like breadth_first_search(),
+ * keeping each layer sorted in a temporary file instead of memory. The
+ * successors of a layer are sorted in runs of bounded size written to disk,
+ * then merged into the next layer, the duplicates being detected on the fly
+ * against the previous two layers. Every file is read and written
+ * sequentially through a buffer, and the bytes read and written are printed
+ * for each layer. The path found is a shortest one.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool external_breadth_first_search(State *current, States *path,
+                                   SearchStats *stats);
 
 #endif // ALGORITHMS_H
\ No newline at end of file
@@ -0,0 +1,388 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of Batch solving
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "batch.h"
+#include "algorithms.h"
+#include "solver.h"
+#include "state.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <threads.h>
+#include <unistd.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines how many instances per thread may be solved ahead of the last
+ * printed one, which bounds the memory held by pending outputs.
+ */
+#define INSTANCES_AHEAD_PER_THREAD 16
+
+/**
+ * Defines the size of the buffer the movements of a path are formatted in
+ * before being written to their stream.
+ */
+#define MOVES_BUFFER_SIZE 4096
+
+/**
+ * @struct Output
+ * @brief The output of a solved instance, waiting to be printed.
+ */
+typedef struct s_output {
+    char *text;
+    size_t size;
+    char *stats;
+    size_t stats_size;
+    bool done;
+} Output;
+
+/**
+ * @struct Shared
+ * @brief State of a batch shared by its workers.
+ */
+typedef struct s_shared {
+    const Batch *batch;
+    int nb_taken;
+    bool exhausted;
+    char *line;
+    size_t line_capacity;
+    int line_number;
+    FILE *quiet;
+    int printed;
+    int window;
+    Output *outputs;
+    mtx_t lock;
+    cnd_t solved;
+    cnd_t printed_changed;
+} Shared;
+
+/**
+ * @struct Worker
+ * @brief A worker thread, with its own path buffer and counters.
+ */
+typedef struct s_worker {
+    Shared *shared;
+    thrd_t thread;
+    States path;
+    BatchTotals totals;
+} Worker;
+
+/*-----------------------------------------------------------------*/
+
+uint64_t next_random(uint64_t *stream) {
+    // splitmix64
+    uint64_t z = (*stream += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void random_permutation(uint8_t *array, int size, uint64_t *stream) {
+    for (int i = size - 1; i > 0; i--) {
+        int j = next_random(stream) % (i + 1); // Get a random index from 0 to i
+        // Swap array[i] and array[j]
+        uint8_t temp = array[i];
+        array[i] = array[j];
+        array[j] = temp;
+    }
+}
+
+uint64_t instance_stream(uint64_t seed, int index) {
+    return seed ^ next_random(&(uint64_t){index});
+}
+
+void generate_instance(uint64_t seed, int index, State *state) {
+    uint64_t random_stream = instance_stream(seed, index);
+    uint8_t array[STATE_WIDTH * STATE_HEIGHT];
+    for (int i = 0; i < STATE_WIDTH * STATE_HEIGHT; i++) {
+        array[i] = i < NB_BLOCKS ? i + 1 : 0;
+    }
+    random_permutation(array, STATE_WIDTH * STATE_HEIGHT, &random_stream);
+    array_to_state(state, array);
+}
+
+/**
+ * Trims the line ending of a line of the input, "\n" or "\r\n", and checks if
+ * the line holds no instance: it is blank, whitespace only, or a comment
+ * starting with '#'.
+ */
+static bool is_skipped_line(char *line, ssize_t length) {
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+        line[--length] = '\0';
+    const char *cursor = line;
+    while (*cursor == ' ' || *cursor == '\t')
+        cursor++;
+    return *cursor == '\0' || *cursor == '#';
+}
+
+/**
+ * Takes the next instance of the batch, generated or read from its input,
+ * with shared->lock held when the workers share the batch. valid is false
+ * for a line of the input that is not a State. Returns false once there is
+ * no instance left.
+ */
+static bool take_instance(Shared *shared, int *index, State *state,
+                          bool *valid) {
+    const Batch *batch = shared->batch;
+    if (shared->exhausted)
+        return false;
+    *valid = true;
+    if (batch->input == NULL) {
+        shared->exhausted = shared->nb_taken >= batch->iterations;
+        if (!shared->exhausted)
+            generate_instance(batch->seed, shared->nb_taken, state);
+    } else {
+        ssize_t length;
+        do {
+            length = getline(&shared->line, &shared->line_capacity,
+                             batch->input);
+            shared->line_number++;
+        } while (length > 0 && is_skipped_line(shared->line, length));
+        shared->exhausted = length <= 0;
+        if (!shared->exhausted) {
+            *valid = parse_state(shared->line, state);
+            if (!*valid)
+                fprintf(stderr, "Line %d: invalid instance\n",
+                        shared->line_number);
+        }
+    }
+    if (shared->exhausted)
+        return false;
+    *index = shared->nb_taken++;
+    return true;
+}
+
+/**
+ * Prints the movements of a path found from root on one line, popping its
+ * states. They are formatted in a local buffer, written out when full.
+ */
+static void fprint_movements(FILE *stream, const State *root, States *path) {
+    char buffer[MOVES_BUFFER_SIZE];
+    size_t size = 0;
+    const State *previous = root;
+    while (path->size > 0) {
+        // Room for " f->t" and the final newline
+        if (size + 6 > sizeof(buffer)) {
+            fwrite(buffer, 1, size, stream);
+            size = 0;
+        }
+        const State *next = pop_state(path);
+        Movement movement = movement_between_states(previous, next);
+        if (previous != root)
+            buffer[size++] = ' ';
+        buffer[size++] = '0' + movement.from;
+        buffer[size++] = '-';
+        buffer[size++] = '>';
+        buffer[size++] = '0' + movement.to;
+        previous = next;
+    }
+    buffer[size++] = '\n';
+    fwrite(buffer, 1, size, stream);
+}
+
+/**
+ * Solves instance index of the batch, printing its results to stream and,
+ * if it is not NULL, its statistics to stats_stream.
+ */
+static void solve_instance(Worker *worker, int index, const State *root,
+                           bool valid, FILE *stream, FILE *stats_stream) {
+    const Batch *batch = worker->shared->batch;
+    clear_states(&worker->path);
+
+    // A parallel algorithm gets the threads, its instances run one by one
+    int nb_threads =
+        is_parallel_algorithm(batch->algorithm) ? batch->nb_threads : 1;
+    SearchStats stats;
+    init_search_stats(&stats);
+    bool found = false;
+    if (valid) {
+        // The search leaves the goal in the state it is given
+        State state = *root;
+        set_search_output(batch->pretty ? stream : worker->shared->quiet);
+        found = solve(batch->algorithm, &state, &worker->path,
+                      batch->step_cost, nb_threads, &stats);
+        set_search_output(NULL);
+        // A worker solves its instances one after the other
+        merge_search_stats(&worker->totals.stats, &stats, false);
+    }
+    if (stats_stream != NULL) {
+        fprintf(stats_stream,
+                "{\"instance\": %d, \"solved\": %s, \"path_length\": %llu, "
+                "\"stats\": ",
+                index, found ? "true" : "false",
+                found ? worker->path.size : 0);
+        fprint_search_stats_json(stats_stream, &stats);
+        fprintf(stats_stream, "}\n");
+    }
+    if (found)
+        worker->totals.solved++;
+    if (!batch->pretty) {
+        if (found)
+            fprint_movements(stream, root, &worker->path);
+        else
+            fputs(valid ? "unsolved\n" : "invalid\n", stream);
+    } else if (found) {
+        if (batch->input == NULL)
+            fprintf(stream, "Goal found %d/%d \n", index + 1,
+                    batch->iterations);
+        else
+            fprintf(stream, "Goal found %d \n", index + 1);
+        fprintf(stream,
+                "Seen States : %llu\nExpanded States : %llu\nCreated States "
+                ": %llu \nSize of the path : %llu\n",
+                (unsigned long long)stats.seen,
+                (unsigned long long)stats.expansions,
+                (unsigned long long)stats.generations, worker->path.size);
+        while (worker->path.size > 0) {
+            fprint_state(stream, pop_state(&worker->path));
+        }
+    } else {
+        fprintf(stream, valid ? "Goal not found\n" : "Invalid instance\n");
+    }
+}
+
+static int run_worker(void *argument) {
+    Worker *worker = argument;
+    Shared *shared = worker->shared;
+    while (true) {
+        int index;
+        State state;
+        bool valid;
+        mtx_lock(&shared->lock);
+        bool taken = take_instance(shared, &index, &state, &valid);
+        if (!taken)
+            cnd_broadcast(&shared->solved);
+        while (taken && index >= shared->printed + shared->window) {
+            cnd_wait(&shared->printed_changed, &shared->lock);
+        }
+        mtx_unlock(&shared->lock);
+        if (!taken)
+            break;
+
+        Output output = {NULL, 0, NULL, 0, true};
+        FILE *stream = open_memstream(&output.text, &output.size);
+        assert(stream != NULL);
+        FILE *stats_stream = NULL;
+        if (shared->batch->stats_output != NULL) {
+            stats_stream = open_memstream(&output.stats, &output.stats_size);
+            assert(stats_stream != NULL);
+        }
+        solve_instance(worker, index, &state, valid, stream, stats_stream);
+        fclose(stream);
+        if (stats_stream != NULL)
+            fclose(stats_stream);
+
+        // The slot of index was freed when index - window was printed
+        mtx_lock(&shared->lock);
+        shared->outputs[index % shared->window] = output;
+        cnd_broadcast(&shared->solved);
+        mtx_unlock(&shared->lock);
+    }
+    return 0;
+}
+
+static void init_worker(Worker *worker, Shared *shared) {
+    worker->shared = shared;
+    init_states(&worker->path);
+    worker->totals.solved = 0;
+    init_search_stats(&worker->totals.stats);
+}
+
+static void merge_worker(Worker *worker, BatchTotals *totals) {
+    totals->solved += worker->totals.solved;
+    // The workers run at the same time, each holding one search at most
+    merge_search_stats(&totals->stats, &worker->totals.stats, true);
+    free_states(&worker->path);
+}
+
+int default_nb_threads(void) {
+    long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return nb_cores > 0 ? (int)nb_cores : 1;
+}
+
+void run_batch(const Batch *batch, BatchTotals *totals) {
+    totals->solved = 0;
+    init_search_stats(&totals->stats);
+    Shared shared = {.batch = batch};
+    // Without pretty printing, the searches have nothing to print
+    if (!batch->pretty)
+        shared.quiet = fopen("/dev/null", "w");
+
+    if (batch->nb_threads <= 1 || is_parallel_algorithm(batch->algorithm)) {
+        // Solve in the calling thread, printing straight to stdout
+        Worker worker;
+        init_worker(&worker, &shared);
+        int index;
+        State state;
+        bool valid;
+        while (take_instance(&shared, &index, &state, &valid)) {
+            solve_instance(&worker, index, &state, valid, stdout,
+                           batch->stats_output);
+        }
+        merge_worker(&worker, totals);
+    } else {
+        // The outputs are a ring of one slot per instance that may be ahead
+        shared.window = INSTANCES_AHEAD_PER_THREAD * batch->nb_threads;
+        shared.outputs = calloc(shared.window, sizeof(Output));
+        assert(shared.outputs != NULL);
+        mtx_init(&shared.lock, mtx_plain);
+        cnd_init(&shared.solved);
+        cnd_init(&shared.printed_changed);
+        Worker *workers = calloc(batch->nb_threads, sizeof(Worker));
+        for (int i = 0; i < batch->nb_threads; i++) {
+            init_worker(&workers[i], &shared);
+            thrd_create(&workers[i].thread, run_worker, &workers[i]);
+        }
+
+        for (int i = 0;; i++) {
+            Output *slot = &shared.outputs[i % shared.window];
+            mtx_lock(&shared.lock);
+            while (!slot->done &&
+                   !(shared.exhausted && i >= shared.nb_taken)) {
+                cnd_wait(&shared.solved, &shared.lock);
+            }
+            Output output = *slot;
+            slot->text = NULL;
+            slot->stats = NULL;
+            slot->done = false;
+            mtx_unlock(&shared.lock);
+            if (!output.done)
+                break;
+
+            fwrite(output.text, 1, output.size, stdout);
+            free(output.text);
+            if (output.stats != NULL)
+                fwrite(output.stats, 1, output.stats_size,
+                       batch->stats_output);
+            free(output.stats);
+
+            mtx_lock(&shared.lock);
+            shared.printed = i + 1;
+            cnd_broadcast(&shared.printed_changed);
+            mtx_unlock(&shared.lock);
+        }
+
+        for (int i = 0; i < batch->nb_threads; i++) {
+            thrd_join(workers[i].thread, NULL);
+            merge_worker(&workers[i], totals);
+        }
+        free(workers);
+        free(shared.outputs);
+        mtx_destroy(&shared.lock);
+        cnd_destroy(&shared.solved);
+        cnd_destroy(&shared.printed_changed);
+    }
+    totals->nb_instances = shared.nb_taken;
+    free(shared.line);
+    if (shared.quiet != NULL)
+        fclose(shared.quiet);
+}
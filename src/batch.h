@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for Batch solving
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef BATCH_H
+#define BATCH_H
+#include "search_stats.h"
+#include "state.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * @struct Batch
+ * @brief A batch of instances solved with one algorithm.
+ *
+ * Instance i is generated from its own random stream, derived from seed and
+ * i, so a batch yields the same instances whatever its number of threads.
+ * When input is set, the instances are read from it instead, one State per
+ * line as parse_state() reads it, until its end, and iterations is ignored;
+ * empty lines and lines starting with '#' are skipped. The input is read as
+ * the instances are solved, so a batch holds only a bounded number of them.
+ * The threads of a batch solving with a parallel algorithm are given to each
+ * search, and its instances are solved one after the other.
+ * When pretty is set, the path of each instance is printed state by state,
+ * otherwise on one line as its movements "from->to", "unsolved" or
+ * "invalid". When stats_output is set, the statistics of each instance are
+ * written to it as one JSON object per line, in the order of the instances.
+ */
+typedef struct s_batch {
+    int iterations;
+    int algorithm;
+    int step_cost;
+    int nb_threads;
+    uint64_t seed;
+    FILE *input;
+    bool pretty;
+    FILE *stats_output;
+} Batch;
+
+/**
+ * @struct BatchTotals
+ * @brief Statistics of a batch, summed over its instances.
+ */
+typedef struct s_batch_totals {
+    int nb_instances;
+    int solved;
+    SearchStats stats;
+} BatchTotals;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Returns the number of threads a batch runs on by default, the number of
+ * online cores.
+ *
+ * @return The default number of threads.
+ */
+int default_nb_threads(void);
+
+/**
+ * Draws the next number of a splitmix64 random stream.
+ *
+ * @param stream The state of the stream, advanced by the call.
+ * @return The random number.
+ */
+uint64_t next_random(uint64_t *stream);
+
+/**
+ * Shuffles an array with the Fisher-Yates algorithm.
+ *
+ * @param array The array to shuffle.
+ * @param size The number of elements of the array.
+ * @param stream The random stream to draw from.
+ */
+void random_permutation(uint8_t *array, int size, uint64_t *stream);
+
+/**
+ * Returns the random stream instance index of a batch is drawn from.
+ *
+ * @param seed The seed of the batch.
+ * @param index The index of the instance in the batch.
+ * @return The initial state of the stream.
+ */
+uint64_t instance_stream(uint64_t seed, int index);
+
+/**
+ * Generates an instance of a batch, a random state with its blocks spread
+ * over the columns.
+ *
+ * @param seed The seed of the batch.
+ * @param index The index of the instance in the batch.
+ * @param state The State object to populate.
+ */
+void generate_instance(uint64_t seed, int index, State *state);
+
+/**
+ * Solves the instances of a batch on a pool of worker threads, each with its
+ * own statistics and buffers. The output of each instance is printed to stdout
+ * in order, as soon as the instances before it are done.
+ *
+ * @param batch The batch to solve.
+ * @param totals The BatchTotals object to populate.
+ */
+void run_batch(const Batch *batch, BatchTotals *totals);
+
+#endif // BATCH_H
@@ -0,0 +1,545 @@
+#include "algorithms.h"
+#include "batch.h"
+#include "solver.h"
+#include <state.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * Defines the version of the instance file format.
+ */
+#define INSTANCE_FILE_VERSION 1
+
+/**
+ * Defines the maximum number of instances of an instance file.
+ */
+#define MAX_INSTANCES 256
+
+/**
+ * Defines the maximum number of repeats of each run.
+ */
+#define MAX_REPEATS 64
+
+/**
+ * Defines the time limit of each repeat, in seconds.
+ */
+#define REPEAT_TIMEOUT 30
+
+#define NB_DIFFICULTIES 3
+
+static const char *difficulty_names[NB_DIFFICULTIES] = {"easy", "medium",
+                                                        "hard"};
+
+/**
+ * Shortest optimal path length of each difficulty. The longest one is 18.
+ */
+static const int difficulty_lengths[NB_DIFFICULTIES] = {0, 10, 14};
+
+#define RUN_SOLVED 0
+#define RUN_UNSOLVED 1
+#define RUN_TIMEOUT 2
+#define RUN_CRASHED 3
+#define RUN_SUBOPTIMAL 4
+
+static const char *status_names[] = {"solved", "unsolved", "timeout",
+                                     "crashed", "suboptimal"};
+
+/**
+ * @struct Instance
+ * @brief An instance of an instance file, with its optimal path length.
+ */
+typedef struct s_instance {
+    int difficulty;
+    int optimal_length;
+    State state;
+} Instance;
+
+/**
+ * @struct Run
+ * @brief Measures of an algorithm on an instance, over every repeat.
+ *
+ * The statistics and path length are those of the last repeat, the
+ * searches being deterministic. Each run happens in a child process, so
+ * peak_rss is the peak resident set size of the algorithm alone, in
+ * kilobytes.
+ */
+typedef struct s_run {
+    int status;
+    int nb_repeats;
+    int path_length;
+    SearchStats stats;
+    long peak_rss;
+    double times[MAX_REPEATS];
+} Run;
+
+/**
+ * @struct Percentiles
+ * @brief Distribution of a set of measures.
+ */
+typedef struct s_percentiles {
+    double min;
+    double median;
+    double p90;
+    double max;
+} Percentiles;
+
+/*-----------------------------------------------------------------*/
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Returns the nearest-rank percentiles of an array of values, sorted in
+ * place.
+ */
+static Percentiles percentiles(double values[], int size) {
+    Percentiles result = {0, 0, 0, 0};
+    if (size == 0)
+        return result;
+    qsort(values, size, sizeof(double), compare_doubles);
+    result.min = values[0];
+    result.median = values[(size + 1) / 2 - 1];
+    result.p90 = values[(size * 9 + 9) / 10 - 1];
+    result.max = values[size - 1];
+    return result;
+}
+
+static double elapsed_since(const struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) +
+           (end.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Reads an instance file: a "version" line, then one instance per line made
+ * of its difficulty, its optimal path length and its 4 columns, each written
+ * as its 3 cells from the bottom up with 0 for an empty cell. Lines starting
+ * with '#' are comments. Returns the number of instances, or -1 if the file
+ * is invalid.
+ */
+static int read_instances(const char *filename, Instance instances[]) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        perror(filename);
+        return -1;
+    }
+    char line[256];
+    int version = -1;
+    int nb_instances = 0;
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+        if (version == -1) {
+            valid = sscanf(line, "version %d", &version) == 1 &&
+                    version == INSTANCE_FILE_VERSION;
+            continue;
+        }
+        char difficulty[16];
+        int offset = 0;
+        Instance *instance = &instances[nb_instances];
+        valid = nb_instances < MAX_INSTANCES &&
+                sscanf(line, "%15s %d %n", difficulty,
+                       &instance->optimal_length, &offset) == 2 &&
+                parse_state(line + offset, &instance->state);
+        instance->difficulty = -1;
+        for (int i = 0; valid && i < NB_DIFFICULTIES; i++) {
+            if (strcmp(difficulty, difficulty_names[i]) == 0)
+                instance->difficulty = i;
+        }
+        valid = valid && instance->difficulty != -1;
+        if (valid)
+            nb_instances++;
+    }
+    fclose(file);
+    if (!valid || version == -1) {
+        fprintf(stderr, "%s: invalid instance file\n", filename);
+        return -1;
+    }
+    return nb_instances;
+}
+
+/**
+ * Prints an instance file of random instances, with as many instances of
+ * each difficulty. Their optimal path lengths come from the breadth first
+ * search.
+ */
+static void generate_instances(uint64_t seed, int nb_per_difficulty) {
+    printf("# Benchmark instances: difficulty, optimal path length and "
+           "columns\n# Generated with seed %llu\nversion %d\n",
+           (unsigned long long)seed, INSTANCE_FILE_VERSION);
+    int counts[NB_DIFFICULTIES] = {0};
+    int nb_done = 0;
+    States path;
+    init_states(&path);
+    SearchStats stats;
+    FILE *quiet = fopen("/dev/null", "w");
+    set_search_output(quiet);
+    for (int index = 0; nb_done < NB_DIFFICULTIES; index++) {
+        State state;
+        init_state(&state);
+        generate_instance(seed, index, &state);
+        State start = state;
+        clear_states(&path);
+        init_search_stats(&stats);
+        solve(8, &state, &path, 1, 1, &stats);
+        int length = path.size;
+        int difficulty = NB_DIFFICULTIES - 1;
+        while (length < difficulty_lengths[difficulty])
+            difficulty--;
+        if (counts[difficulty] == nb_per_difficulty)
+            continue;
+        if (++counts[difficulty] == nb_per_difficulty)
+            nb_done++;
+        printf("%-6s %2d", difficulty_names[difficulty], length);
+        for (int i = 0; i < STATE_WIDTH; i++) {
+            printf(" ");
+            for (int j = 0; j < STATE_HEIGHT; j++) {
+                printf("%d", start.state[i][j]);
+            }
+        }
+        printf("\n");
+    }
+    set_search_output(NULL);
+    if (quiet != NULL)
+        fclose(quiet);
+    free_states(&path);
+}
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Solves an instance with an algorithm in the calling process, repeats
+ * times, and writes the measures to a file descriptor. A path of an optimal
+ * algorithm whose length is not the optimal one of the instance makes the
+ * run suboptimal.
+ */
+static void measure_run(int algorithm, const Instance *instance, int repeats,
+                        int nb_threads, int fd) {
+    FILE *quiet = fopen("/dev/null", "w");
+    set_search_output(quiet);
+    prepare_algorithm(algorithm);
+    Run run = {.status = RUN_SOLVED};
+    States path;
+    init_states(&path);
+    for (int i = 0; i < repeats && run.status == RUN_SOLVED; i++) {
+        State state = instance->state;
+        clear_states(&path);
+        init_search_stats(&run.stats);
+        alarm(REPEAT_TIMEOUT);
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool found =
+            solve(algorithm, &state, &path, 1, nb_threads, &run.stats);
+        run.times[i] = elapsed_since(&start);
+        alarm(0);
+        run.status = found ? RUN_SOLVED : RUN_UNSOLVED;
+        run.nb_repeats = i + 1;
+        run.path_length = path.size;
+        // An optimal algorithm must find a path of the optimal length
+        if (found && is_optimal_algorithm(algorithm) &&
+            run.path_length != instance->optimal_length)
+            run.status = RUN_SUBOPTIMAL;
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    run.peak_rss = usage.ru_maxrss;
+    write(fd, &run, sizeof(Run));
+    free_states(&path);
+    release_algorithm(algorithm);
+}
+
+/**
+ * Measures an algorithm on an instance in a child process, which is killed
+ * by SIGALRM when a repeat exceeds REPEAT_TIMEOUT.
+ */
+static Run benchmark_run(int algorithm, const Instance *instance,
+                         int repeats, int nb_threads) {
+    Run run = {.status = RUN_CRASHED};
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe failed");
+        exit(EXIT_FAILURE);
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork failed");
+        exit(EXIT_FAILURE);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        measure_run(algorithm, instance, repeats, nb_threads, fds[1]);
+        _exit(EXIT_SUCCESS);
+    }
+    close(fds[1]);
+    Run measured;
+    bool complete = read(fds[0], &measured, sizeof(Run)) == sizeof(Run);
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    if (complete)
+        run = measured;
+    else if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+        run.status = RUN_TIMEOUT;
+    return run;
+}
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Parses a comma separated list of algorithm ids, or "all". Returns the
+ * number of algorithms, or -1 if the list is invalid.
+ */
+static int parse_algorithms(const char *list, int algorithms[]) {
+    int nb_algorithms = 0;
+    if (strcmp(list, "all") == 0) {
+        for (int i = 0; i < NB_ALGORITHMS; i++) {
+            algorithms[nb_algorithms++] = i;
+        }
+        return nb_algorithms;
+    }
+    const char *start = list;
+    while (*start != '\0') {
+        char *end;
+        long algorithm = strtol(start, &end, 10);
+        if (end == start || algorithm_name(algorithm) == NULL ||
+            nb_algorithms == NB_ALGORITHMS || (*end != ',' && *end != '\0'))
+            return -1;
+        algorithms[nb_algorithms++] = algorithm;
+        start = *end == ',' ? end + 1 : end;
+    }
+    return nb_algorithms;
+}
+
+static double nodes_per_second(const Run *run, double time) {
+    return time > 0 ? run->stats.expansions / time : 0.0;
+}
+
+static void write_csv(FILE *file, const Instance instances[],
+                      int nb_instances, const int algorithms[],
+                      int nb_algorithms, Run *runs) {
+    fprintf(file, "algorithm,name,instance,difficulty,optimal_length,status,"
+                  "path_length,seen,expanded,generated,duplicates,"
+                  "iterations,open_peak,closed_peak,time_min,time_median,"
+                  "time_p90,time_max,nodes_per_second,peak_rss_kb\n");
+    for (int a = 0; a < nb_algorithms; a++) {
+        for (int i = 0; i < nb_instances; i++) {
+            Run *run = &runs[a * nb_instances + i];
+            const SearchStats *stats = &run->stats;
+            Percentiles time = percentiles(run->times, run->nb_repeats);
+            fprintf(file,
+                    "%d,\"%s\",%d,%s,%d,%s,%d,%llu,%llu,%llu,%llu,%llu,%llu,"
+                    "%llu,%.6f,%.6f,%.6f,%.6f,%.0f,%ld\n",
+                    algorithms[a], algorithm_name(algorithms[a]), i,
+                    difficulty_names[instances[i].difficulty],
+                    instances[i].optimal_length, status_names[run->status],
+                    run->path_length, (unsigned long long)stats->seen,
+                    (unsigned long long)stats->expansions,
+                    (unsigned long long)stats->generations,
+                    (unsigned long long)stats->duplicates,
+                    (unsigned long long)stats->iterations,
+                    (unsigned long long)stats->open_peak,
+                    (unsigned long long)stats->closed_peak, time.min,
+                    time.median, time.p90, time.max,
+                    nodes_per_second(run, time.median), run->peak_rss);
+        }
+    }
+}
+
+/**
+ * Writes the measures of every run and, per algorithm and difficulty, the
+ * percentiles of the median times of the solved instances.
+ */
+static void write_json(FILE *file, const char *instance_file, int repeats,
+                       int nb_threads, const Instance instances[],
+                       int nb_instances, const int algorithms[],
+                       int nb_algorithms, Run *runs) {
+    fprintf(file,
+            "{\n  \"instance_file\": \"%s\",\n  \"repeats\": %d,\n"
+            "  \"threads\": %d,\n  \"algorithms\": [",
+            instance_file, repeats, nb_threads);
+    for (int a = 0; a < nb_algorithms; a++) {
+        fprintf(file,
+                "%s\n    {\n      \"id\": %d,\n      \"name\": \"%s\",\n"
+                "      \"runs\": [",
+                a == 0 ? "" : ",", algorithms[a],
+                algorithm_name(algorithms[a]));
+        double medians[NB_DIFFICULTIES][MAX_INSTANCES];
+        int nb_medians[NB_DIFFICULTIES] = {0};
+        for (int i = 0; i < nb_instances; i++) {
+            Run *run = &runs[a * nb_instances + i];
+            Percentiles time = percentiles(run->times, run->nb_repeats);
+            if (run->status == RUN_SOLVED) {
+                int difficulty = instances[i].difficulty;
+                medians[difficulty][nb_medians[difficulty]++] = time.median;
+            }
+            fprintf(file,
+                    "%s\n        {\"instance\": %d, \"difficulty\": \"%s\", "
+                    "\"optimal_length\": %d, \"status\": \"%s\", "
+                    "\"path_length\": %d, \"time\": {\"min\": %.6f, "
+                    "\"median\": %.6f, \"p90\": %.6f, \"max\": %.6f}, "
+                    "\"nodes_per_second\": %.0f, \"peak_rss_kb\": %ld, "
+                    "\"stats\": ",
+                    i == 0 ? "" : ",", i,
+                    difficulty_names[instances[i].difficulty],
+                    instances[i].optimal_length, status_names[run->status],
+                    run->path_length, time.min, time.median, time.p90,
+                    time.max, nodes_per_second(run, time.median),
+                    run->peak_rss);
+            fprint_search_stats_json(file, &run->stats);
+            fprintf(file, "}");
+        }
+        fprintf(file, "\n      ],\n      \"summary\": {");
+        for (int d = 0; d < NB_DIFFICULTIES; d++) {
+            Percentiles time = percentiles(medians[d], nb_medians[d]);
+            fprintf(file,
+                    "%s\n        \"%s\": {\"solved\": %d, \"time\": "
+                    "{\"min\": %.6f, \"median\": %.6f, \"p90\": %.6f, "
+                    "\"max\": %.6f}}",
+                    d == 0 ? "" : ",", difficulty_names[d], nb_medians[d],
+                    time.min, time.median, time.p90, time.max);
+        }
+        fprintf(file, "\n      }\n    }");
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+static FILE *open_output(const char *prefix, const char *extension) {
+    char filename[1024];
+    snprintf(filename, sizeof(filename), "%s.%s", prefix, extension);
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        perror(filename);
+        exit(EXIT_FAILURE);
+    }
+    return file;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "--generate") == 0) {
+        unsigned long long seed;
+        int nb_per_difficulty;
+        if (sscanf(argv[2], "%llu", &seed) != 1 ||
+            sscanf(argv[3], "%d", &nb_per_difficulty) != 1 ||
+            nb_per_difficulty < 1 ||
+            nb_per_difficulty * NB_DIFFICULTIES > MAX_INSTANCES) {
+            fprintf(stderr, "Invalid seed or number of instances\n");
+            exit(EXIT_FAILURE);
+        }
+        generate_instances(seed, nb_per_difficulty);
+        return 0;
+    }
+    if (argc < 2 || argc > 5) {
+        fprintf(stderr,
+                "Usage: %s <instance file> [repeats] [algorithms] "
+                "[output prefix]\n       %s --generate <seed> <instances per "
+                "difficulty>\nAlgorithms are comma separated ids, or all.\n",
+                argv[0], argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    static Instance instances[MAX_INSTANCES];
+    int nb_instances = read_instances(argv[1], instances);
+    int repeats = 3;
+    int algorithms[NB_ALGORITHMS];
+    int nb_algorithms = parse_algorithms(argc >= 4 ? argv[3] : "all",
+                                         algorithms);
+    if (nb_instances < 0 ||
+        (argc >= 3 && sscanf(argv[2], "%d", &repeats) != 1) ||
+        repeats < 1 || repeats > MAX_REPEATS || nb_algorithms < 1) {
+        fprintf(stderr, "Invalid instance file, repeats or algorithms\n");
+        exit(EXIT_FAILURE);
+    }
+    int nb_threads = default_nb_threads();
+
+    printf("%d instances, %d repeats, %d threads for the parallel "
+           "algorithms\n",
+           nb_instances, repeats, nb_threads);
+    printf("%-48s %-6s %6s %10s %10s %14s %12s %10s %7s\n", "algorithm",
+           "class", "solved", "median (s)", "p90 (s)", "expanded",
+           "nodes/s", "rss (kB)", "length");
+    Run *runs = calloc((size_t)nb_algorithms * nb_instances, sizeof(Run));
+    int nb_failed = 0;
+    for (int a = 0; a < nb_algorithms; a++) {
+        for (int i = 0; i < nb_instances; i++) {
+            Run *run = &runs[a * nb_instances + i];
+            *run = benchmark_run(algorithms[a], &instances[i], repeats,
+                                 nb_threads);
+            if (run->status == RUN_SUBOPTIMAL)
+                fprintf(stderr, "%s: path of length %d on instance %d, "
+                                "whose optimal length is %d\n",
+                        algorithm_name(algorithms[a]), run->path_length, i,
+                        instances[i].optimal_length);
+            else if (run->status == RUN_CRASHED)
+                fprintf(stderr, "%s: crashed on instance %d\n",
+                        algorithm_name(algorithms[a]), i);
+            nb_failed += run->status == RUN_SUBOPTIMAL ||
+                         run->status == RUN_CRASHED;
+        }
+        // One line per difficulty, over the solved instances
+        for (int d = 0; d < NB_DIFFICULTIES; d++) {
+            double times[MAX_INSTANCES];
+            long long expanded = 0;
+            long peak_rss = 0;
+            int nb_total = 0, nb_solved = 0, length = 0;
+            for (int i = 0; i < nb_instances; i++) {
+                Run *run = &runs[a * nb_instances + i];
+                if (instances[i].difficulty != d)
+                    continue;
+                nb_total++;
+                if (run->peak_rss > peak_rss)
+                    peak_rss = run->peak_rss;
+                if (run->status != RUN_SOLVED)
+                    continue;
+                double sorted[MAX_REPEATS];
+                memcpy(sorted, run->times, run->nb_repeats * sizeof(double));
+                times[nb_solved++] =
+                    percentiles(sorted, run->nb_repeats).median;
+                expanded += run->stats.expansions;
+                length += run->path_length;
+            }
+            if (nb_total == 0)
+                continue;
+            double total_time = 0;
+            for (int i = 0; i < nb_solved; i++) {
+                total_time += times[i];
+            }
+            Percentiles time = percentiles(times, nb_solved);
+            printf("%-48s %-6s %3d/%-2d %10.4f %10.4f %14lld %12.0f %10ld "
+                   "%7.1f\n",
+                   algorithm_name(algorithms[a]), difficulty_names[d],
+                   nb_solved, nb_total, time.median, time.p90, expanded,
+                   total_time > 0 ? expanded / total_time : 0.0, peak_rss,
+                   nb_solved > 0 ? (double)length / nb_solved : 0.0);
+        }
+    }
+
+    if (argc == 5) {
+        FILE *json = open_output(argv[4], "json");
+        write_json(json, argv[1], repeats, nb_threads, instances,
+                   nb_instances, algorithms, nb_algorithms, runs);
+        fclose(json);
+        FILE *csv = open_output(argv[4], "csv");
+        write_csv(csv, instances, nb_instances, algorithms, nb_algorithms,
+                  runs);
+        fclose(csv);
+    }
+    free(runs);
+    // A suboptimal path or a crash is a regression, timeouts are not
+    return nb_failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,72 @@
+#include <state.h>
+#include <state_index.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Checks that a State holds every block exactly once and no empty cell below
+ * a block.
+ */
+static bool is_valid_state(const State *state) {
+    bool seen[NB_BLOCKS + 1] = {false};
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        if (state->nb_element[i] > STATE_HEIGHT)
+            return false;
+        for (int j = 0; j < state->nb_element[i]; j++) {
+            int block = state->state[i][j];
+            if (block < 1 || block > NB_BLOCKS || seen[block])
+                return false;
+            seen[block] = true;
+        }
+    }
+    for (int block = 1; block <= NB_BLOCKS; block++) {
+        if (!seen[block])
+            return false;
+    }
+    return true;
+}
+
+int main(void) {
+    // Every index gives a valid state that ranks back to it, so the ranking
+    // is a bijection between the indices and as many valid states, which are
+    // all of them if there are as many indices as states
+    unsigned long long nb_states = nb_state_indices();
+    unsigned long long nb_errors = 0;
+    for (unsigned long long i = 0; i < nb_states; i++) {
+        StateIndex index = (StateIndex)i;
+        PackedState packed = packed_state_from_index(index);
+        State state;
+        state_from_index(index, &state);
+        bool valid = is_valid_state(&state) && pack_state(&state) == packed &&
+                     packed_state_index(packed) == index &&
+                     state_index(&state) == index;
+        if (!valid && nb_errors++ < 10)
+            fprintf(stderr, "Index %llu does not round-trip\n", i);
+    }
+
+    // As many indices as states: NB_BLOCKS! orders per way of spreading the
+    // blocks over the columns, counted here without the index
+    unsigned long long nb_orders = 1;
+    for (int i = 2; i <= NB_BLOCKS; i++) {
+        nb_orders *= i;
+    }
+    unsigned long long nb_heights = 0;
+    for (int heights = 0; heights < NB_HEIGHT_SIGNATURES; heights++) {
+        int sum = 0;
+        bool valid = true;
+        for (int i = 0; i < STATE_WIDTH; i++) {
+            int height = (heights >> (2 * i)) & 0x3;
+            sum += height;
+            valid = valid && height <= STATE_HEIGHT;
+        }
+        nb_heights += valid && sum == NB_BLOCKS;
+    }
+    if (nb_states != nb_orders * nb_heights) {
+        fprintf(stderr, "%llu indices for %llu states\n", nb_states,
+                nb_orders * nb_heights);
+        nb_errors++;
+    }
+    printf("Checked %llu state indices, %llu errors\n", nb_states, nb_errors);
+    return nb_errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
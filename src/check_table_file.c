@@ -0,0 +1,106 @@
+#include "pattern_database.h"
+#include "table_file.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Defines the file damaged and rebuilt by the checks.
+ */
+#define CHECK_FILE "check_pattern_database.bin"
+
+static uint8_t *read_file(const char *filename, size_t *size) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    rewind(file);
+    uint8_t *data = malloc(*size);
+    if (data != NULL && fread(data, 1, *size, file) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+static bool write_file(const char *filename, const uint8_t *data,
+                       size_t size) {
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+        return false;
+    bool written = fwrite(data, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+/**
+ * Writes a copy of a valid pattern database cut to size bytes, with the byte
+ * at offset flipped if it is within them, then checks that the copy is
+ * rejected by the mapping when it is damaged, accepted otherwise, and that
+ * loading the pattern database leaves the original in the file.
+ */
+static bool check_file(const char *name, const uint8_t *original,
+                       size_t original_size, size_t size, size_t offset) {
+    bool damaged_file = size != original_size || offset < size;
+    uint8_t *damaged = malloc(original_size);
+    assert(damaged != NULL);
+    memcpy(damaged, original, original_size);
+    if (offset < size)
+        damaged[offset] ^= 0xFF;
+    bool written = write_file(CHECK_FILE, damaged, size);
+    free(damaged);
+
+    const TableFileHeader *header = (const TableFileHeader *)original;
+    TableFile file;
+    bool rejected = !map_table_file(&file, CHECK_FILE,
+                                    TABLE_KIND_PATTERN_DATABASE, PATTERN_SIZE,
+                                    NB_PATTERNS, header->table_size);
+    if (!rejected)
+        unmap_table_file(&file);
+
+    bool rebuilt = load_pattern_database(CHECK_FILE);
+    unload_pattern_database();
+    size_t rebuilt_size;
+    uint8_t *data = read_file(CHECK_FILE, &rebuilt_size);
+    rebuilt = rebuilt && data != NULL && rebuilt_size == original_size &&
+              memcmp(data, original, original_size) == 0;
+    free(data);
+    printf("%-16s %s, %s\n", name, rejected ? "rejected" : "accepted",
+           rebuilt ? "rebuilt" : "not rebuilt");
+    return written && rejected == damaged_file && rebuilt;
+}
+
+int main(void) {
+    if (!generate_pattern_database(CHECK_FILE)) {
+        perror("Could not write the pattern database");
+        exit(EXIT_FAILURE);
+    }
+    size_t size;
+    uint8_t *original = read_file(CHECK_FILE, &size);
+    if (original == NULL || size <= sizeof(TableFileHeader)) {
+        fprintf(stderr, "Could not read back %s\n", CHECK_FILE);
+        exit(EXIT_FAILURE);
+    }
+
+    // A valid file is mapped as is, every damaged one is replaced
+    size_t tables = sizeof(TableFileHeader);
+    bool passed =
+        check_file("Valid file", original, size, size, size) &&
+        check_file("Wrong magic", original, size, size,
+                   offsetof(TableFileHeader, magic)) &&
+        check_file("Wrong version", original, size, size,
+                   offsetof(TableFileHeader, version)) &&
+        check_file("Wrong kind", original, size, size,
+                   offsetof(TableFileHeader, kind)) &&
+        check_file("Wrong size", original, size, size - 1, size) &&
+        check_file("Bad checksum", original, size, size,
+                   tables + (size - tables) / 2);
+    free(original);
+    remove(CHECK_FILE);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,68 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of puzzle Configurations
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "configurations.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/*-----------------------------------------------------------------*/
+
+#define GRID_WIDTH 3
+#define GRID_HEIGHT 3
+#define GRID_BLOCKS 6
+#define GRID_SUFFIX 3x3x6
+#include "grid_template.h"
+
+#define GRID_WIDTH 4
+#define GRID_HEIGHT 3
+#define GRID_BLOCKS 9
+#define GRID_SUFFIX 4x3x9
+#include "grid_template.h"
+
+#define GRID_WIDTH 4
+#define GRID_HEIGHT 4
+#define GRID_BLOCKS 12
+#define GRID_SUFFIX 4x4x12
+#include "grid_template.h"
+
+#define GRID_WIDTH 5
+#define GRID_HEIGHT 3
+#define GRID_BLOCKS 12
+#define GRID_SUFFIX 5x3x12
+#include "grid_template.h"
+
+/*-----------------------------------------------------------------*/
+
+static const Configuration configurations[] = {
+    {"3x3x6", 3, 3, 6, run_grid_batch_3x3x6},
+    {"4x3x9", 4, 3, 9, run_grid_batch_4x3x9},
+    {"4x4x12", 4, 4, 12, run_grid_batch_4x4x12},
+    {"5x3x12", 5, 3, 12, run_grid_batch_5x3x12},
+};
+
+#define NB_CONFIGURATIONS                                                      \
+    (int)(sizeof(configurations) / sizeof(configurations[0]))
+
+const Configuration *find_configuration(const char *name) {
+    for (int i = 0; i < NB_CONFIGURATIONS; i++) {
+        if (strcmp(configurations[i].name, name) == 0)
+            return &configurations[i];
+    }
+    return NULL;
+}
+
+void print_configurations(FILE *stream) {
+    for (int i = 0; i < NB_CONFIGURATIONS; i++) {
+        fprintf(stream, i == 0 ? "%s" : " %s", configurations[i].name);
+    }
+}
+
+bool is_configurable_algorithm(int algorithm) {
+    return algorithm == 6 || algorithm == 7;
+}
@@ -0,0 +1,61 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for puzzle Configurations
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef CONFIGURATIONS_H
+#define CONFIGURATIONS_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * @struct Configuration
+ * @brief Dimensions of a puzzle, with the code specialized for them.
+ *
+ * The State based algorithms are built for STATE_WIDTH, STATE_HEIGHT and
+ * NB_BLOCKS only. Each Configuration runs an IDA* over grids of its own
+ * dimensions, instantiated from grid_template.h.
+ */
+typedef struct s_configuration {
+    const char *name;
+    int width;
+    int height;
+    int nb_blocks;
+    int (*run_batch)(int iterations, int algorithm, int step_cost,
+                     uint64_t seed);
+} Configuration;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Looks up a configuration by name, e.g. "4x3x9" for 4 columns of height 3
+ * holding 9 blocks.
+ *
+ * @param name The name of the configuration.
+ * @return The configuration, or NULL if none has this name.
+ */
+const Configuration *find_configuration(const char *name);
+
+/**
+ * Prints the names of the configurations built in, separated by spaces.
+ *
+ * @param stream The stream to print to.
+ */
+void print_configurations(FILE *stream);
+
+/**
+ * Checks if an algorithm can run on any configuration. Only the IDA*
+ * searches with the misplaced cubes and Manhattan distance heuristics can.
+ *
+ * @param algorithm The id of the algorithm.
+ * @return True if the algorithm can run on any configuration.
+ */
+bool is_configurable_algorithm(int algorithm);
+
+#endif // CONFIGURATIONS_H
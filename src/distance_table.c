@@ -0,0 +1,236 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of the Distance table
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "distance_table.h"
+#include "search_stats.h"
+#include "state.h"
+#include "state_index.h"
+#include "table_file.h"
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <unistd.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Marks a state not reached yet while building the table.
+ */
+#define UNKNOWN_DISTANCE 0xFF
+
+/**
+ * Defines the mask of an entry of the table, the residue of its distance.
+ */
+#define DISTANCE_MASK ((1 << DISTANCE_BITS) - 1)
+
+static const uint8_t *table = NULL;
+static TableFile table_file;
+
+/**
+ * @struct LayerSlice
+ * @brief The state indices a thread scans for the states of a layer, and
+ * the number of states it reached from them.
+ *
+ * The distances are atomic bytes: a state reached by several threads at once
+ * is only counted by the one whose compare-exchange succeeds.
+ */
+typedef struct s_layer_slice {
+    _Atomic uint8_t *distances;
+    StateIndex begin;
+    StateIndex end;
+    int distance;
+    unsigned long long nb_reached;
+    thrd_t thread;
+} LayerSlice;
+
+/*-----------------------------------------------------------------*/
+
+static unsigned long long table_size(void) {
+    return (nb_state_indices() + 1) / 2;
+}
+
+static int table_entry(StateIndex index) {
+    return (table[index >> 1] >> (DISTANCE_BITS * (index & 1))) &
+           DISTANCE_MASK;
+}
+
+/**
+ * Gives the states at distance + 1 the neighbours of the states of the
+ * slice at distance that have no distance yet.
+ */
+static int expand_layer_slice(void *argument) {
+    LayerSlice *slice = argument;
+    slice->nb_reached = 0;
+    for (StateIndex i = slice->begin; i < slice->end; i++) {
+        if (atomic_load_explicit(&slice->distances[i],
+                                 memory_order_relaxed) != slice->distance)
+            continue;
+        PackedState packed = packed_state_from_index(i);
+        const HeightMoves *moves = height_moves(height_signature(packed));
+        for (int j = 0; j < moves->nb_movement; j++) {
+            PackedState child =
+                apply_movement_to_packed_state(packed, moves->movements[j]);
+            _Atomic uint8_t *distance =
+                &slice->distances[packed_state_index(child)];
+            uint8_t unknown = UNKNOWN_DISTANCE;
+            if (atomic_load_explicit(distance, memory_order_relaxed) ==
+                    UNKNOWN_DISTANCE &&
+                atomic_compare_exchange_strong_explicit(
+                    distance, &unknown, slice->distance + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                slice->nb_reached++;
+        }
+    }
+    return 0;
+}
+
+uint8_t *build_distance_table(unsigned long long *size, int nb_threads) {
+    assert(nb_threads >= 1);
+    StateIndex nb_states = nb_state_indices();
+    _Atomic uint8_t *distances = malloc(nb_states);
+    assert(distances != NULL);
+    for (StateIndex i = 0; i < nb_states; i++) {
+        atomic_init(&distances[i], UNKNOWN_DISTANCE);
+    }
+    int nb_goal;
+    PackedState *goals = packed_goal_states(&nb_goal);
+    for (int i = 0; i < nb_goal; i++) {
+        atomic_init(&distances[packed_state_index(goals[i])], 0);
+    }
+    free(goals);
+
+    // The threads are joined after each layer, the next one reading it whole
+    LayerSlice *slices = calloc(nb_threads, sizeof(LayerSlice));
+    assert(slices != NULL);
+    unsigned long long nb_reached = nb_goal;
+    for (int distance = 0; nb_reached > 0; distance++) {
+        assert(distance + 1 < UNKNOWN_DISTANCE);
+        for (int i = 0; i < nb_threads; i++) {
+            slices[i] = (LayerSlice){
+                .distances = distances,
+                .begin = (unsigned long long)nb_states * i / nb_threads,
+                .end = (unsigned long long)nb_states * (i + 1) / nb_threads,
+                .distance = distance,
+            };
+            thrd_create(&slices[i].thread, expand_layer_slice, &slices[i]);
+        }
+        nb_reached = 0;
+        for (int i = 0; i < nb_threads; i++) {
+            thrd_join(slices[i].thread, NULL);
+            nb_reached += slices[i].nb_reached;
+        }
+    }
+    free(slices);
+
+    *size = table_size();
+    uint8_t *packed_table = calloc(*size, 1);
+    assert(packed_table != NULL);
+    for (StateIndex i = 0; i < nb_states; i++) {
+        uint8_t distance = atomic_load(&distances[i]);
+        assert(distance != UNKNOWN_DISTANCE);
+        packed_table[i >> 1] |= (distance & DISTANCE_MASK)
+                                << (DISTANCE_BITS * (i & 1));
+    }
+    free(distances);
+    return packed_table;
+}
+
+bool generate_distance_table(const char *filename, int nb_threads) {
+    if (nb_threads <= 0) {
+        long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+        nb_threads = nb_cores > 0 ? (int)nb_cores : 1;
+    }
+    unsigned long long size;
+    uint8_t *distances = build_distance_table(&size, nb_threads);
+    bool saved = write_table_file(filename, TABLE_KIND_DISTANCE_TABLE,
+                                  DISTANCE_BITS, 1, size, distances);
+    free(distances);
+    return saved;
+}
+
+bool load_distance_table(const char *filename) {
+    unload_distance_table();
+    if (map_table_file(&table_file, filename, TABLE_KIND_DISTANCE_TABLE,
+                       DISTANCE_BITS, 1, table_size())) {
+        table = table_file.tables;
+        return true;
+    }
+    if (generate_distance_table(filename, 0) &&
+        map_table_file(&table_file, filename, TABLE_KIND_DISTANCE_TABLE,
+                       DISTANCE_BITS, 1, table_size())) {
+        table = table_file.tables;
+        return true;
+    }
+    fprintf(stderr, "Could not save the distance table to %s\n", filename);
+    unsigned long long size;
+    table = build_distance_table(&size, 1);
+    return false;
+}
+
+void unload_distance_table(void) {
+    if (table_file.mapping != NULL)
+        unmap_table_file(&table_file);
+    else
+        free((void *)table);
+    table = NULL;
+}
+
+bool distance_table_search(State *current, States *path, SearchStats *stats) {
+    assert(table != NULL);
+    STATS_PHASE(stats, SEARCH_PHASE_SEARCH);
+    int capacity = 32, length = 0;
+    PackedState *states = malloc(capacity * sizeof(PackedState));
+    assert(states != NULL);
+    states[0] = pack_state(current);
+    int entry = table_entry(packed_state_index(states[0]));
+    while (!is_packed_goal_state(states[length])) {
+        STATS_ADD(stats, expansions, 1);
+        if (length + 1 == capacity) {
+            capacity *= 2;
+            states = realloc(states, capacity * sizeof(PackedState));
+            assert(states != NULL);
+        }
+        // The neighbour one movement closer, whose residue is one less
+        int closer = (entry - 1) & DISTANCE_MASK;
+        const HeightMoves *moves =
+            height_moves(height_signature(states[length]));
+        bool found = false;
+        for (int i = 0; i < moves->nb_movement && !found; i++) {
+            STATS_ADD(stats, generations, 1);
+            PackedState child = apply_movement_to_packed_state(
+                states[length], moves->movements[i]);
+            found = table_entry(packed_state_index(child)) == closer;
+            if (found)
+                states[length + 1] = child;
+        }
+        assert(found);
+        entry = closer;
+        length++;
+    }
+    STATS_ADD(stats, seen, length + 1);
+
+    // Same path as the searches: the goal in current, the states down to
+    // the first movement pushed from the goal back
+    STATS_PHASE(stats, SEARCH_PHASE_PATH);
+    unpack_state(states[length], current);
+    current->depth = length;
+    reserve_states(path, path->size + length);
+    for (int i = length; i > 0; i--) {
+        State state;
+        unpack_state(states[i], &state);
+        state.depth = i;
+        push_state(path, &state);
+    }
+    STATS_PHASE(stats, NO_SEARCH_PHASE);
+    free(states);
+    return true;
+}
@@ -0,0 +1,86 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for the Distance table
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef DISTANCE_TABLE_H
+#define DISTANCE_TABLE_H
+#include "search_stats.h"
+#include "state.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the number of bits of an entry of the distance table.
+ */
+#define DISTANCE_BITS 4
+
+/**
+ * Defines the file the distance table is saved to.
+ */
+#define DISTANCE_TABLE_FILE "distance_table.bin"
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Loads the distance table, memory-mapping it from a table file. If the file
+ * does not exist or is not valid for the current dimensions, the table is
+ * built and saved to the file first.
+ *
+ * @param filename The file of the distance table.
+ * @return true if the table is mapped from the file, false if it could not
+ * be saved and is kept in memory instead.
+ */
+bool load_distance_table(const char *filename);
+
+/**
+ * Builds the distance table and saves it to a table file, replacing any
+ * existing file.
+ *
+ * @param filename The file of the distance table.
+ * @param nb_threads The number of threads of the build, or 0 for one per
+ * online core.
+ * @return true if the file was written, false otherwise.
+ */
+bool generate_distance_table(const char *filename, int nb_threads);
+
+/**
+ * Releases the distance table.
+ */
+void unload_distance_table(void);
+
+/**
+ * Builds the distance table.
+ *
+ * The table holds the distance to the nearest goal of every state, indexed
+ * by its StateIndex, modulo 16 on DISTANCE_BITS bits. It is computed by a
+ * retrograde breadth first search from the goal states, one layer at a time,
+ * each layer being expanded by nb_threads threads over slices of the state
+ * indices. The distances of two neighbouring states differ by at most one,
+ * so their residues modulo 16 are enough to tell which neighbour is closer to
+ * a goal.
+ *
+ * @param size A pointer to store the size of the table in bytes.
+ * @param nb_threads The number of threads of the build, at least 1.
+ * @return The table, two entries per byte with the even indices in the low
+ * nibbles, to be freed by the caller.
+ */
+uint8_t *build_distance_table(unsigned long long *size, int nb_threads);
+
+/**
+ * Solves an instance optimally with the distance table, by moving to a
+ * neighbour one movement closer to a goal until a goal is reached.
+ *
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param stats The statistics of the search, added to.
+ * @return True, every state being solvable.
+ */
+bool distance_table_search(State *current, States *path, SearchStats *stats);
+
+#endif // DISTANCE_TABLE_H
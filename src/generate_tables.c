@@ -0,0 +1,55 @@
+#include "distance_table.h"
+#include "pattern_database.h"
+#include "table_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static void print_table_file(const char *name, const char *filename) {
+    TableFileHeader header;
+    read_table_file_header(filename, &header);
+    printf("%s written to %s\n"
+           "Version : %u\nState : %ux%u with %u blocks\nTables : %llu x %llu "
+           "bytes\nChecksum : %016llx\n",
+           name, filename, header.version, header.state_width,
+           header.state_height, header.nb_blocks,
+           (unsigned long long)header.nb_tables,
+           (unsigned long long)header.table_size,
+           (unsigned long long)header.checksum);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 3) {
+        fprintf(stderr,
+                "Usage: %s [pattern database file] [distance table file]\n",
+                argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    const char *filename = argc >= 2 ? argv[1] : PATTERN_DATABASE_FILE;
+    const char *distance_filename = argc == 3 ? argv[2] : DISTANCE_TABLE_FILE;
+
+    if (!generate_pattern_database(filename)) {
+        perror("Could not write the pattern database");
+        exit(EXIT_FAILURE);
+    }
+    // Map the file back, which checks its header and checksum
+    if (!load_pattern_database(filename)) {
+        fprintf(stderr, "Could not map the pattern database %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    print_table_file("Pattern database", filename);
+    unload_pattern_database();
+
+    // The distance table is built on every online core
+    if (!generate_distance_table(distance_filename, 0)) {
+        perror("Could not write the distance table");
+        exit(EXIT_FAILURE);
+    }
+    if (!load_distance_table(distance_filename)) {
+        fprintf(stderr, "Could not map the distance table %s\n",
+                distance_filename);
+        exit(EXIT_FAILURE);
+    }
+    print_table_file("Distance table", distance_filename);
+    unload_distance_table();
+    return 0;
+}
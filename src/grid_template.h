@@ -0,0 +1,321 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Template for Grids of fixed dimensions
+ **/
+/*-----------------------------------------------------------------*/
+
+/*
+ * Instantiates a Grid type, its move generation, goal test, heuristics and
+ * an IDA* search for one puzzle configuration. Define GRID_WIDTH,
+ * GRID_HEIGHT, GRID_BLOCKS and GRID_SUFFIX before each inclusion, e.g. for
+ * GRID_SUFFIX 4x3x9 the type is Grid_4x3x9 and the goal test
+ * is_goal_grid_4x3x9(). The dimensions are constants in every function, so
+ * their loops have fixed trip counts the compiler unrolls. The goal test and
+ * heuristics sum the column terms of column_costs.h, like those of the
+ * State, and the IDA* prunes the same duplicates as ida_star_pass(). This
+ * file has no include guard: it is meant to be included once per
+ * configuration, and undefines its parameters at the end.
+ */
+
+#if !defined(GRID_WIDTH) || !defined(GRID_HEIGHT) ||                          \
+    !defined(GRID_BLOCKS) || !defined(GRID_SUFFIX)
+#error "GRID_WIDTH, GRID_HEIGHT, GRID_BLOCKS and GRID_SUFFIX must be defined"
+#endif
+
+#include "batch.h"
+#include "column_costs.h"
+#include "state.h"
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GRID_NAME
+#define GRID_CONCAT_(name, suffix) name##_##suffix
+#define GRID_CONCAT(name, suffix) GRID_CONCAT_(name, suffix)
+#define GRID_NAME(name) GRID_CONCAT(name, GRID_SUFFIX)
+#endif
+
+#define GRID_MAX_MOVEMENTS (GRID_WIDTH * (GRID_WIDTH - 1))
+#define GRID_CELL_OFFSET(column, level)                                        \
+    (4 * ((column) * GRID_HEIGHT + (level)))
+#define Grid GRID_NAME(Grid)
+#define GridSearch GRID_NAME(GridSearch)
+
+_Static_assert(GRID_BLOCKS % GRID_HEIGHT == 0,
+               "the blocks must fill whole columns");
+_Static_assert(GRID_BLOCKS < GRID_WIDTH * GRID_HEIGHT,
+               "a configuration needs a free cell to move blocks");
+_Static_assert(GRID_BLOCKS < 16 && GRID_WIDTH * GRID_HEIGHT <= 16,
+               "the keys of the grids hold their cells on 4 bits each");
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * @struct Grid
+ * @brief A state of the configuration, without predecessor nor depth.
+ */
+typedef struct GRID_NAME(s_grid) {
+    uint8_t cells[GRID_WIDTH][GRID_HEIGHT];
+    uint8_t heights[GRID_WIDTH];
+} Grid;
+
+/**
+ * @struct GridSearch
+ * @brief State of an IDA* search over grids, shared by its recursive calls.
+ *
+ * path holds the keys of the grids from the root to the current one and
+ * movements the movements between them, both growing with capacity.
+ */
+typedef struct GRID_NAME(s_grid_search) {
+    Grid grid;
+    uint64_t *path;
+    Movement *movements;
+    int capacity;
+    int goal_depth;
+    int (*heuristic)(const Grid *);
+    int step_cost;
+    long long nb_expanded;
+    long long nb_generated;
+} GridSearch;
+
+/*-----------------------------------------------------------------*/
+
+static void GRID_NAME(array_to_grid)(Grid *grid, const uint8_t array[]) {
+    memset(grid, 0, sizeof(Grid));
+    for (int i = 0; i < GRID_WIDTH; i++) {
+        for (int j = 0; j < GRID_HEIGHT; j++) {
+            uint8_t element = array[i * GRID_HEIGHT + j];
+            if (element != 0)
+                grid->cells[i][grid->heights[i]++] = element;
+        }
+    }
+}
+
+static int GRID_NAME(grid_movements)(const Grid *grid, Movement movements[]) {
+    int nb_movement = 0;
+    for (int i = 0; i < GRID_WIDTH; i++) {
+        for (int j = 0; j < GRID_WIDTH; j++) {
+            if (i != j && grid->heights[i] != 0 &&
+                grid->heights[j] != GRID_HEIGHT) {
+                movements[nb_movement].from = i;
+                movements[nb_movement].to = j;
+                nb_movement++;
+            }
+        }
+    }
+    return nb_movement;
+}
+
+static void GRID_NAME(apply_grid_movement)(Grid *grid, Movement movement) {
+    assert(grid->heights[movement.from] != 0 &&
+           grid->heights[movement.to] != GRID_HEIGHT);
+    uint8_t *from = &grid->cells[movement.from][grid->heights[movement.from]];
+    grid->cells[movement.to][grid->heights[movement.to]] = from[-1];
+    from[-1] = 0;
+    grid->heights[movement.from]--;
+    grid->heights[movement.to]++;
+}
+
+static void GRID_NAME(undo_grid_movement)(Grid *grid, Movement movement) {
+    Movement undo = {.from = movement.to, .to = movement.from};
+    GRID_NAME(apply_grid_movement)(grid, undo);
+}
+
+/**
+ * Same rule as is_goal_state(): every column follows is_goal_column().
+ */
+static bool GRID_NAME(is_goal_grid)(const Grid *grid) {
+    for (int i = 0; i < GRID_WIDTH; i++) {
+        if (!is_goal_column(grid->cells[i], grid->heights[i], GRID_HEIGHT))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Same heuristic as misplaced_cubes().
+ */
+static int GRID_NAME(grid_misplaced_cubes)(const Grid *grid) {
+    int misplaced = 0;
+    for (int i = 0; i < GRID_WIDTH; i++) {
+        misplaced += misplaced_cubes_of_column(grid->cells[i],
+                                               grid->heights[i], GRID_HEIGHT);
+    }
+    return misplaced;
+}
+
+/**
+ * Same heuristic as manhattan_distance().
+ */
+static int GRID_NAME(grid_manhattan_distance)(const Grid *grid) {
+    int distance = 0;
+    for (int i = 0; i < GRID_WIDTH; i++) {
+        distance += manhattan_distance_of_column(
+            grid->cells[i], grid->heights[i], i, GRID_HEIGHT);
+    }
+    return distance;
+}
+
+/**
+ * Returns the key of a grid, its cells packed on 4 bits each like those of a
+ * PackedState. The heights are those of the nonzero cells.
+ */
+static uint64_t GRID_NAME(grid_key)(const Grid *grid) {
+    uint64_t key = 0;
+    for (int i = 0; i < GRID_WIDTH; i++) {
+        for (int j = 0; j < GRID_HEIGHT; j++) {
+            key |= (uint64_t)grid->cells[i][j] << GRID_CELL_OFFSET(i, j);
+        }
+    }
+    return key;
+}
+
+/**
+ * Returns the key of a grid from the key of its parent, given the grid and
+ * the movement that led to it, which only moved one block.
+ */
+static uint64_t GRID_NAME(moved_grid_key)(const Grid *grid, uint64_t key,
+                                          Movement movement) {
+    int to_level = grid->heights[movement.to] - 1;
+    uint64_t block = grid->cells[movement.to][to_level];
+    return key ^
+           block << GRID_CELL_OFFSET(movement.from,
+                                     grid->heights[movement.from]) ^
+           block << GRID_CELL_OFFSET(movement.to, to_level);
+}
+
+/**
+ * Same check as is_on_path() of ida_star_pass(): whether the key of a child
+ * of the grid at the given depth is one of those from the root to it. The
+ * child differs from its grid, and from the parent of its grid by the
+ * parent-move pruning, so they are skipped.
+ */
+static bool GRID_NAME(is_grid_on_path)(const GridSearch *search, uint64_t key,
+                                       int depth) {
+    for (int i = depth - 2; i >= 0; i--) {
+        if (search->path[i] == key)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Runs an IDA* pass below the current grid of a search. Returns -1 if a goal
+ * grid is found, else the minimum cost exceeding the threshold.
+ */
+static int GRID_NAME(grid_ida_star_pass)(GridSearch *search, int depth,
+                                          int threshold) {
+    int cost = depth * search->step_cost + search->heuristic(&search->grid);
+    if (cost > threshold)
+        return cost;
+    if (GRID_NAME(is_goal_grid)(&search->grid)) {
+        search->goal_depth = depth;
+        return -1;
+    }
+    search->nb_expanded++;
+    if (depth + 1 == search->capacity) {
+        search->capacity *= 2;
+        search->path =
+            realloc(search->path, search->capacity * sizeof(uint64_t));
+        search->movements = realloc(search->movements,
+                                    search->capacity * sizeof(Movement));
+        assert(search->path != NULL && search->movements != NULL);
+    }
+    Movement movements[GRID_MAX_MOVEMENTS];
+    int nb_movement = GRID_NAME(grid_movements)(&search->grid, movements);
+    int min_cost_exceeding_threshold = INT_MAX;
+    for (int i = 0; i < nb_movement; i++) {
+        Movement movement = movements[i];
+        // Parent-move pruning: never undo the movement that led here
+        if (depth > 0 && movement.from == search->movements[depth - 1].to &&
+            movement.to == search->movements[depth - 1].from)
+            continue;
+        search->nb_generated++;
+        GRID_NAME(apply_grid_movement)(&search->grid, movement);
+        uint64_t key = GRID_NAME(moved_grid_key)(&search->grid,
+                                                 search->path[depth], movement);
+        // Cycle check: never come back to a grid of the current path
+        if (GRID_NAME(is_grid_on_path)(search, key, depth)) {
+            GRID_NAME(undo_grid_movement)(&search->grid, movement);
+            continue;
+        }
+        search->path[depth + 1] = key;
+        search->movements[depth] = movement;
+        int result =
+            GRID_NAME(grid_ida_star_pass)(search, depth + 1, threshold);
+        GRID_NAME(undo_grid_movement)(&search->grid, movement);
+        if (result == -1)
+            return -1;
+        if (result < min_cost_exceeding_threshold)
+            min_cost_exceeding_threshold = result;
+    }
+    return min_cost_exceeding_threshold;
+}
+
+/**
+ * Solves the random instances of a batch for the configuration, one after
+ * the other, printing the movements of each path found.
+ *
+ * @return The number of instances solved.
+ */
+static int GRID_NAME(run_grid_batch)(int iterations, int algorithm,
+                                      int step_cost, uint64_t seed) {
+    int nb_solved = 0;
+    GridSearch search = {
+        .capacity = 64,
+        .heuristic = algorithm == 6 ? GRID_NAME(grid_misplaced_cubes)
+                                    : GRID_NAME(grid_manhattan_distance),
+        .step_cost = step_cost,
+    };
+    search.path = malloc(search.capacity * sizeof(uint64_t));
+    search.movements = malloc(search.capacity * sizeof(Movement));
+    for (int index = 0; index < iterations; index++) {
+        uint64_t random_stream = instance_stream(seed, index);
+        uint8_t array[GRID_WIDTH * GRID_HEIGHT];
+        for (int i = 0; i < GRID_WIDTH * GRID_HEIGHT; i++) {
+            array[i] = i < GRID_BLOCKS ? i + 1 : 0;
+        }
+        random_permutation(array, GRID_WIDTH * GRID_HEIGHT, &random_stream);
+        GRID_NAME(array_to_grid)(&search.grid, array);
+        search.path[0] = GRID_NAME(grid_key)(&search.grid);
+        search.nb_expanded = 0;
+        search.nb_generated = 0;
+
+        int threshold = search.heuristic(&search.grid);
+        while (threshold != -1 && threshold != INT_MAX) {
+            threshold = GRID_NAME(grid_ida_star_pass)(&search, 0, threshold);
+        }
+        if (threshold == INT_MAX) {
+            printf("Goal not found\n");
+            continue;
+        }
+        nb_solved++;
+        printf("Goal found %d/%d \nExpanded States : %lld\nCreated States : "
+               "%lld \nSize of the path : %d\nMovements :",
+               index + 1, iterations, search.nb_expanded, search.nb_generated,
+               search.goal_depth);
+        for (int i = 0; i < search.goal_depth; i++) {
+            printf(" %d->%d", search.movements[i].from,
+                   search.movements[i].to);
+        }
+        printf("\n");
+    }
+    free(search.path);
+    free(search.movements);
+    return nb_solved;
+}
+
+#undef Grid
+#undef GridSearch
+#undef GRID_MAX_MOVEMENTS
+#undef GRID_CELL_OFFSET
+#undef GRID_WIDTH
+#undef GRID_HEIGHT
+#undef GRID_BLOCKS
+#undef GRID_SUFFIX
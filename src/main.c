@@ -1,151 +1,165 @@
 #include "algorithms.h"
+#include "batch.h"
+#include "configurations.h"
+#include "solver.h"
 #include <state.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-void random_permutation(uint8_t *array, int size) {
-    for (int i = size - 1; i > 0; i--) {
-        int j = rand() % (i + 1); // Get a random index from 0 to i
-        // Swap array[i] and array[j]
-        uint8_t temp = array[i];
-        array[i] = array[j];
-        array[j] = temp;
-    }
+/**
+ * Defines the size of the buffer of stdout when the paths are printed as
+ * movements, so that they are written in large blocks.
+ */
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s <number of iterations> <algorithm> <step_cost> "
+            "[threads] [configuration] [options]\n       %s --input "
+            "<file|-> <algorithm> <step_cost> [threads] [options]\nOptions: "
+            "--pretty, --compact, --stats <file>, --table <MB>\n"
+            "Configurations: ",
+            program, program);
+    print_configurations(stderr);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
 }
 
 int main(int argc, char **argv) {
-    srand(time(NULL));
+    // The options may come anywhere: "--input <file>" streams the instances
+    // from a file, or stdin for "-", instead of generating them, "--pretty"
+    // and "--compact" print the paths state by state or as movements,
+    // "--stats <file>" exports the statistics of each instance as JSON lines
+    // and "--table <MB>" gives each IDA* search, or each thread of a parallel
+    // IDA* search, a transposition table
+    const char *input_file = NULL;
+    const char *stats_file = NULL;
+    int table_megabytes = 0;
+    int pretty = -1;
+    int nb_arguments = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pretty") == 0 ||
+            strcmp(argv[i], "--compact") == 0)
+            pretty = strcmp(argv[i], "--pretty") == 0;
+        else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc)
+            input_file = argv[++i];
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+            stats_file = argv[++i];
+        else if (strcmp(argv[i], "--table") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d", &table_megabytes) != 1 ||
+                table_megabytes < 0)
+                usage(argv[0]);
+        } else
+            argv[nb_arguments++] = argv[i];
+    }
+    argc = nb_arguments;
+    // Streamed instances have no count, the other arguments shift left
+    int first = input_file != NULL ? 0 : 1;
+    if (argc < 3 + first || argc > 4 + 2 * first)
+        usage(argv[0]);
 
-    if (argc != 4) {
-        fprintf(stderr,
-                "Usage: %s <number of iterations> <algorithm> <step_cost>\n",
-                argv[0]);
+    Batch batch;
+    batch.iterations = 0;
+    if (sscanf(argv[1 + first], "%d", &batch.algorithm) != 1 ||
+        (first == 1 && sscanf(argv[1], "%d", &batch.iterations) != 1) ||
+        sscanf(argv[2 + first], "%d", &batch.step_cost) != 1) {
+        perror("sscanf failed");
         exit(EXIT_FAILURE);
     }
-
-    int *infos = calloc(3, sizeof(int));
-    int iterations, algorithm, step_cost;
-    if (sscanf(argv[2], "%d", &algorithm) != 1 ||
-        sscanf(argv[1], "%d", &iterations) != 1 ||
-        sscanf(argv[3], "%d", &step_cost) != 1) {
+    // Without a thread count, instances are solved one after the other
+    batch.nb_threads = 1;
+    if (argc >= 4 + first &&
+        sscanf(argv[3 + first], "%d", &batch.nb_threads) != 1) {
         perror("sscanf failed");
         exit(EXIT_FAILURE);
     }
+    if (batch.nb_threads <= 0)
+        batch.nb_threads = default_nb_threads();
+    batch.seed = time(NULL);
 
-    switch (algorithm) {
-    case 0:
-        printf("Using depth first search\n");
-        for (int i = 0; i < iterations; i++) {
-            State state;
-            States path;
-            init_state(&state);
-            init_states(&path);
-            uint8_t array[STATE_WIDTH * STATE_HEIGHT] = {1, 2, 3, 4, 5, 6,
-                                                         7, 8, 9, 0, 0, 0};
-            random_permutation(array, STATE_WIDTH * STATE_HEIGHT);
-            array_to_state(&state, array);
-            if (depth_first_search(&state, &path, &infos)) {
-                printf("Goal found %d/%d \nSeen States : %d\nCreated States "
-                       ": %d \nNumber of Iterations : %d\nSize of the path : "
-                       "%llu\n",
-                       i + 1, iterations, infos[0], infos[1], infos[2],
-                       path.size);
-                while (path.size > 0) {
-                    State *state = pop_state(&path);
-                    print_state(state);
-                }
-            } else {
-                printf("Goal not found\n");
-            }
-        }
-        break;
-    case 1:
-        printf("Using iterative deepening\n");
-        for (int i = 0; i < iterations; i++) {
-            State state;
-            States path;
-            init_state(&state);
-            init_states(&path);
-            uint8_t array[STATE_WIDTH * STATE_HEIGHT] = {1, 2, 3, 4, 5, 6,
-                                                         7, 8, 9, 0, 0, 0};
-            random_permutation(array, STATE_WIDTH * STATE_HEIGHT);
-            array_to_state(&state, array);
-            if (iterative_deepening(&state, &path, &infos)) {
-                printf("Goal found %d/%d \nSeen States : %d\nCreated States "
-                       ": %d \nNumber of Iterations : %d\nSize of the path : "
-                       "%llu\n",
-                       i + 1, iterations, infos[0], infos[1], infos[2],
-                       path.size);
-                while (path.size > 0) {
-                    State *state = pop_state(&path);
-                    print_state(state);
-                }
-            } else {
-                printf("Goal not found\n");
-            }
-        }
-        break;
-    case 2:
-        printf("Using misplaced cubes heuristic\n");
-        for (int i = 0; i < iterations; i++) {
-            State state;
-            States path;
-            init_state(&state);
-            init_states(&path);
-            uint8_t array[STATE_WIDTH * STATE_HEIGHT] = {1, 2, 3, 4, 5, 6,
-                                                         7, 8, 9, 0, 0, 0};
-            random_permutation(array, STATE_WIDTH * STATE_HEIGHT);
-            array_to_state(&state, array);
-            if (iterative_deepening_with_heuristic(
-                    &state, &path, misplaced_cubes, step_cost, &infos)) {
-                printf("Goal found %d/%d \nSeen States : %d\nCreated States "
-                       ": %d \nNumber of Iterations : %d\nSize of the path : "
-                       "%llu\n",
-                       i + 1, iterations, infos[0], infos[1], infos[2],
-                       path.size);
+    const char *name = algorithm_name(batch.algorithm);
+    if (name == NULL) {
+        printf("Invalid heuristic\n");
+        exit(EXIT_FAILURE);
+    }
+    // Only the IDA* searches of this puzzle have a transposition table
+    if (table_megabytes > 0 &&
+        (!uses_transposition_table(batch.algorithm) || argc == 6)) {
+        fprintf(stderr, "--table is only for the IDA* algorithms\n");
+        exit(EXIT_FAILURE);
+    }
 
-                while (path.size > 0) {
-                    State *state = pop_state(&path);
-                    print_state(state);
-                }
-            } else {
-                printf("Goal not found\n");
-            }
+    if (argc == 6) {
+        // Other dimensions run the IDA* specialized for them
+        const Configuration *configuration = find_configuration(argv[5]);
+        if (configuration == NULL ||
+            !is_configurable_algorithm(batch.algorithm)) {
+            fprintf(stderr, "Invalid configuration or algorithm\n");
+            exit(EXIT_FAILURE);
         }
-        break;
-    case 3:
-        printf("Using Manhattan distance heuristic\n");
-        for (int i = 0; i < iterations; i++) {
-            State state;
-            States path;
-            init_state(&state);
-            init_states(&path);
-            uint8_t array[STATE_WIDTH * STATE_HEIGHT] = {1, 2, 3, 4, 5, 6,
-                                                         7, 8, 9, 0, 0, 0};
-            random_permutation(array, STATE_WIDTH * STATE_HEIGHT);
-            array_to_state(&state, array);
-            if (iterative_deepening_with_heuristic(
-                    &state, &path, manhattan_distance, step_cost, &infos)) {
-                printf("Goal found %d/%d \nSeen States : %d\nCreated States "
-                       ": %d \nNumber of Iterations : %d\nSize of the path : "
-                       "%llu\n",
-                       i + 1, iterations, infos[0], infos[1], infos[2],
-                       path.size);
-                while (path.size > 0) {
-                    State *state = pop_state(&path);
-                    print_state(state);
-                }
-            } else {
-                printf("Goal not found\n");
-            }
+        printf("Using %s on %d columns of height %d with %d blocks\n", name,
+               configuration->width, configuration->height,
+               configuration->nb_blocks);
+        int nb_solved = configuration->run_batch(
+            batch.iterations, batch.algorithm, batch.step_cost, batch.seed);
+        printf("Solved %d/%d\n", nb_solved, batch.iterations);
+        return nb_solved == batch.iterations ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    set_ida_star_table_size((size_t)table_megabytes << 20);
+    // Streamed instances print their movements unless asked otherwise
+    batch.pretty = pretty != -1 ? pretty : input_file == NULL;
+    batch.input = NULL;
+    if (input_file != NULL) {
+        batch.input =
+            strcmp(input_file, "-") == 0 ? stdin : fopen(input_file, "r");
+        if (batch.input == NULL) {
+            perror(input_file);
+            exit(EXIT_FAILURE);
         }
-        break;
-    default:
-        printf("Invalid heuristic\n");
-        exit(EXIT_FAILURE);
     }
-    free(infos);
-    return 0;
+    batch.stats_output = NULL;
+    if (stats_file != NULL) {
+        batch.stats_output = fopen(stats_file, "w");
+        if (batch.stats_output == NULL) {
+            perror(stats_file);
+            exit(EXIT_FAILURE);
+        }
+    }
+    // The movements alone go to stdout, through a large buffer
+    FILE *report = stdout;
+    if (!batch.pretty) {
+        setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+        report = stderr;
+    }
+    fprintf(report, "Using %s\n", name);
+    fflush(report);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    prepare_algorithm(batch.algorithm);
+    BatchTotals totals;
+    run_batch(&batch, &totals);
+    release_algorithm(batch.algorithm);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fflush(stdout);
+    if (batch.input != NULL && batch.input != stdin)
+        fclose(batch.input);
+    if (batch.stats_output != NULL)
+        fclose(batch.stats_output);
+
+    double elapsed =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    fprintf(report,
+            "Solved %d/%d on %d thread(s) in %.3f s\nTotal Seen States : "
+            "%llu\nTotal Expanded States : %llu\nTotal Created States : "
+            "%llu\n",
+            totals.solved, totals.nb_instances, batch.nb_threads, elapsed,
+            (unsigned long long)totals.stats.seen,
+            (unsigned long long)totals.stats.expansions,
+            (unsigned long long)totals.stats.generations);
+    // Any unsolved or invalid instance fails the run, for the tests
+    return totals.solved == totals.nb_instances ? EXIT_SUCCESS : EXIT_FAILURE;
 }
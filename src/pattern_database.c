@@ -0,0 +1,224 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of the Pattern database heuristic
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "pattern_database.h"
+#include "state.h"
+#include "state_index.h"
+#include "table_file.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Stands for any block outside the pattern in an abstract state.
+ */
+#define ANONYMOUS_BLOCK 0xF
+
+/**
+ * Marks an abstract state not reached yet while building a table.
+ */
+#define UNKNOWN_DISTANCE 0xFF
+
+static const uint8_t *tables = NULL;
+static unsigned long long loaded_table_size = 0;
+static TableFile table_file;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Returns the number of entries of a table per height configuration, one per
+ * placement of the pattern blocks on the NB_BLOCKS occupied cells.
+ */
+static unsigned long long entries_per_configuration(void) {
+    unsigned long long entries = 1;
+    for (int i = 0; i < PATTERN_SIZE; i++) {
+        entries *= NB_BLOCKS;
+    }
+    return entries;
+}
+
+static unsigned long long table_size(void) {
+    return nb_height_configurations() * entries_per_configuration();
+}
+
+/**
+ * Stores in positions the rank of the cell of each block, column by column
+ * from the bottom up.
+ */
+static void block_positions(PackedState packed, int positions[16]) {
+    int position = 0;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        for (int j = 0; j < packed_height(packed, i); j++) {
+            positions[(packed >> PACKED_CELL_OFFSET(i, j)) & 0xF] = position++;
+        }
+    }
+}
+
+/**
+ * Returns the index of the abstract state of a pattern in its table.
+ */
+static unsigned long long pattern_index(unsigned int configuration,
+                                        const int positions[16],
+                                        int pattern) {
+    unsigned long long index = configuration;
+    for (int k = 1; k <= PATTERN_SIZE; k++) {
+        index = index * NB_BLOCKS + positions[pattern * PATTERN_SIZE + k];
+    }
+    return index;
+}
+
+static PackedState abstract_state(PackedState packed, int pattern) {
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        for (int j = 0; j < packed_height(packed, i); j++) {
+            int offset = PACKED_CELL_OFFSET(i, j);
+            int block = (packed >> offset) & 0xF;
+            if ((block - 1) / PATTERN_SIZE != pattern)
+                packed |= (PackedState)ANONYMOUS_BLOCK << offset;
+        }
+    }
+    return packed;
+}
+
+static unsigned long long abstract_index(PackedState abstract, int pattern) {
+    int positions[16];
+    block_positions(abstract, positions);
+    return pattern_index(height_configuration(abstract), positions, pattern);
+}
+
+static void push_packed(PackedState **array, unsigned long long *size,
+                        unsigned long long *capacity, PackedState packed) {
+    if (*size == *capacity) {
+        *capacity = *capacity == 0 ? 1024 : *capacity * 2;
+        *array = realloc(*array, *capacity * sizeof(PackedState));
+        assert(*array != NULL);
+    }
+    (*array)[(*size)++] = packed;
+}
+
+/**
+ * Fills the table of a pattern, layer by layer: the states of layer d are
+ * closed under free movements of anonymous blocks before the movements of
+ * pattern blocks seed layer d + 1.
+ */
+static void build_pattern_table(uint8_t *table, int pattern) {
+    PackedState *stack = NULL, *next = NULL;
+    unsigned long long stack_size = 0, stack_capacity = 0;
+    unsigned long long next_size = 0, next_capacity = 0;
+    Movement movements[MAX_MOVEMENTS];
+    memset(table, UNKNOWN_DISTANCE, table_size());
+
+    int nb_goal;
+    PackedState *goals = packed_goal_states(&nb_goal);
+    for (int i = 0; i < nb_goal; i++) {
+        push_packed(&next, &next_size, &next_capacity,
+                    abstract_state(goals[i], pattern));
+    }
+    free(goals);
+
+    for (int distance = 0; next_size > 0; distance++) {
+        assert(distance < UNKNOWN_DISTANCE);
+        for (unsigned long long i = 0; i < next_size; i++) {
+            unsigned long long index = abstract_index(next[i], pattern);
+            if (table[index] != UNKNOWN_DISTANCE)
+                continue;
+            table[index] = distance;
+            push_packed(&stack, &stack_size, &stack_capacity, next[i]);
+        }
+        next_size = 0;
+        while (stack_size > 0) {
+            PackedState abstract = stack[--stack_size];
+            int nb_movement = packed_possible_movements(abstract, movements);
+            for (int i = 0; i < nb_movement; i++) {
+                int from = movements[i].from;
+                int from_top =
+                    PACKED_CELL_OFFSET(from, packed_height(abstract, from) - 1);
+                bool free_movement =
+                    ((abstract >> from_top) & 0xF) == ANONYMOUS_BLOCK;
+                PackedState child =
+                    apply_movement_to_packed_state(abstract, movements[i]);
+                if (!free_movement) {
+                    push_packed(&next, &next_size, &next_capacity, child);
+                    continue;
+                }
+                unsigned long long index = abstract_index(child, pattern);
+                if (table[index] != UNKNOWN_DISTANCE)
+                    continue;
+                table[index] = distance;
+                push_packed(&stack, &stack_size, &stack_capacity, child);
+            }
+        }
+    }
+    free(stack);
+    free(next);
+}
+
+uint8_t *build_pattern_database(unsigned long long *size) {
+    *size = NB_PATTERNS * table_size();
+    uint8_t *database = malloc(*size);
+    assert(database != NULL);
+    for (int pattern = 0; pattern < NB_PATTERNS; pattern++) {
+        build_pattern_table(database + pattern * table_size(), pattern);
+    }
+    return database;
+}
+
+bool generate_pattern_database(const char *filename) {
+    unsigned long long size;
+    uint8_t *database = build_pattern_database(&size);
+    bool saved =
+        write_table_file(filename, TABLE_KIND_PATTERN_DATABASE, PATTERN_SIZE,
+                         NB_PATTERNS, size / NB_PATTERNS, database);
+    free(database);
+    return saved;
+}
+
+bool load_pattern_database(const char *filename) {
+    unload_pattern_database();
+    loaded_table_size = table_size();
+    if (map_table_file(&table_file, filename, TABLE_KIND_PATTERN_DATABASE,
+                       PATTERN_SIZE, NB_PATTERNS, loaded_table_size)) {
+        tables = table_file.tables;
+        return true;
+    }
+    if (generate_pattern_database(filename) &&
+        map_table_file(&table_file, filename, TABLE_KIND_PATTERN_DATABASE,
+                       PATTERN_SIZE, NB_PATTERNS, loaded_table_size)) {
+        tables = table_file.tables;
+        return true;
+    }
+    fprintf(stderr, "Could not save the pattern database to %s\n", filename);
+    unsigned long long size;
+    tables = build_pattern_database(&size);
+    return false;
+}
+
+void unload_pattern_database(void) {
+    if (table_file.mapping != NULL)
+        unmap_table_file(&table_file);
+    else
+        free((void *)tables);
+    tables = NULL;
+}
+
+int pattern_database(State state) {
+    assert(tables != NULL);
+    PackedState packed = pack_state(&state);
+    int positions[16];
+    block_positions(packed, positions);
+    unsigned int configuration = height_configuration(packed);
+    int distance = 0;
+    for (int pattern = 0; pattern < NB_PATTERNS; pattern++) {
+        distance += tables[pattern * loaded_table_size +
+                           pattern_index(configuration, positions, pattern)];
+    }
+    return distance;
+}
@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for the Pattern database heuristic
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef PATTERN_DATABASE_H
+#define PATTERN_DATABASE_H
+#include "state.h"
+#include <stdbool.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the number of blocks of a pattern. The patterns are the blocks 1 to
+ * PATTERN_SIZE, PATTERN_SIZE + 1 to 2 * PATTERN_SIZE, and so on.
+ */
+#define PATTERN_SIZE 3
+
+/**
+ * Defines the number of disjoint patterns.
+ */
+#define NB_PATTERNS (NB_BLOCKS / PATTERN_SIZE)
+
+/**
+ * Defines the file the pattern database is saved to.
+ */
+#define PATTERN_DATABASE_FILE "pattern_database.bin"
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Loads the pattern database, memory-mapping it from a table file. If the file
+ * does not exist or is not valid for the current dimensions, the database is
+ * built and saved to the file first.
+ *
+ * @param filename The file of the pattern database.
+ * @return true if the database is mapped from the file, false if it could
+ * not be saved and is kept in memory instead.
+ */
+bool load_pattern_database(const char *filename);
+
+/**
+ * Builds the pattern database and saves it to a table file, replacing any
+ * existing file.
+ *
+ * @param filename The file of the pattern database.
+ * @return true if the file was written, false otherwise.
+ */
+bool generate_pattern_database(const char *filename);
+
+/**
+ * Releases the pattern database.
+ */
+void unload_pattern_database(void);
+
+/**
+ * Builds the pattern database tables.
+ *
+ * For each pattern, the table holds for every abstract state, where only the
+ * blocks of the pattern are told apart, the minimum number of movements of
+ * pattern blocks needed to reach an abstract goal. It is computed by a
+ * retrograde breadth first search from the abstract goals, where moving a
+ * block outside the pattern costs nothing.
+ *
+ * @param size A pointer to store the size of the tables in bytes.
+ * @return The tables, one byte per abstract state, to be freed by the caller.
+ */
+uint8_t *build_pattern_database(unsigned long long *size);
+
+/**
+ * Calculate the pattern database heuristic of the state, the sum of the
+ * distances of its patterns. Each movement moves a block of a single pattern,
+ * so the sum never overestimates the distance to a goal.
+ *
+ * @param state The state to evaluate.
+ * @return The pattern database heuristic value.
+ */
+int pattern_database(State state);
+
+#endif // PATTERN_DATABASE_H
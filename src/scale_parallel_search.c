@@ -0,0 +1,78 @@
+#include "algorithms.h"
+#include "batch.h"
+#include "solver.h"
+#include <state.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+int main(int argc, char **argv) {
+    if (argc < 3 || argc > 5) {
+        fprintf(stderr,
+                "Usage: %s <number of instances> <parallel algorithm> "
+                "[max threads] [seed]\n",
+                argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    // Every thread count solves the same instances, those of the seed given
+    // to compare runs, or else of one printed to repeat this run
+    int nb_instances, algorithm;
+    int max_threads = default_nb_threads();
+    unsigned long long seed = time(NULL);
+    if (sscanf(argv[1], "%d", &nb_instances) != 1 ||
+        sscanf(argv[2], "%d", &algorithm) != 1 ||
+        (argc >= 4 && sscanf(argv[3], "%d", &max_threads) != 1) ||
+        (argc == 5 && sscanf(argv[4], "%llu", &seed) != 1)) {
+        perror("sscanf failed");
+        exit(EXIT_FAILURE);
+    }
+    if (!is_parallel_algorithm(algorithm) || max_threads < 1) {
+        fprintf(stderr, "Invalid parallel algorithm or thread count\n");
+        exit(EXIT_FAILURE);
+    }
+
+    FILE *quiet = fopen("/dev/null", "w");
+    set_search_output(quiet);
+    prepare_algorithm(algorithm);
+    printf("Using %s on %d instances of seed %llu\n",
+           algorithm_name(algorithm), nb_instances, seed);
+    printf("%8s %10s %14s %14s %8s\n", "threads", "time (s)", "nodes",
+           "nodes/s", "speedup");
+
+    double base_elapsed = 0;
+    States path;
+    init_states(&path);
+    for (int nb_threads = 1; nb_threads <= max_threads;
+         nb_threads = nb_threads < max_threads && nb_threads * 2 > max_threads
+                          ? max_threads
+                          : nb_threads * 2) {
+        long long nb_nodes = 0;
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < nb_instances; i++) {
+            State state;
+            init_state(&state);
+            clear_states(&path);
+            generate_instance(seed, i, &state);
+            SearchStats stats;
+            init_search_stats(&stats);
+            solve(algorithm, &state, &path, 1, nb_threads, &stats);
+            nb_nodes += stats.expansions;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double elapsed =
+            (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+        if (nb_threads == 1)
+            base_elapsed = elapsed;
+        printf("%8d %10.3f %14lld %14.0f %8.2f\n", nb_threads, elapsed,
+               nb_nodes, elapsed > 0 ? nb_nodes / elapsed : 0.0,
+               elapsed > 0 ? base_elapsed / elapsed : 0.0);
+    }
+    release_algorithm(algorithm);
+    set_search_output(NULL);
+    if (quiet != NULL)
+        fclose(quiet);
+    free_states(&path);
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of Search statistics
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "search_stats.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*-----------------------------------------------------------------*/
+
+static const char *phase_names[NB_SEARCH_PHASES] = {"setup", "search",
+                                                    "path"};
+
+void init_search_stats(SearchStats *stats) {
+    memset(stats, 0, sizeof(SearchStats));
+    stats->phase = NO_SEARCH_PHASE;
+}
+
+void enter_search_phase(SearchStats *stats, int phase) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (stats->phase != NO_SEARCH_PHASE)
+        stats->phase_seconds[stats->phase] +=
+            (now.tv_sec - stats->phase_start.tv_sec) +
+            (now.tv_nsec - stats->phase_start.tv_nsec) * 1e-9;
+    stats->phase = phase;
+    stats->phase_start = now;
+}
+
+void merge_search_stats(SearchStats *stats, const SearchStats *other,
+                        bool concurrent) {
+    stats->seen += other->seen;
+    stats->expansions += other->expansions;
+    stats->generations += other->generations;
+    stats->duplicates += other->duplicates;
+    stats->iterations += other->iterations;
+    if (concurrent) {
+        stats->open_peak += other->open_peak;
+        stats->closed_peak += other->closed_peak;
+    } else {
+        if (other->open_peak > stats->open_peak)
+            stats->open_peak = other->open_peak;
+        if (other->closed_peak > stats->closed_peak)
+            stats->closed_peak = other->closed_peak;
+    }
+    for (int i = 0; i < NB_SEARCH_PHASES; i++) {
+        stats->phase_seconds[i] += other->phase_seconds[i];
+    }
+}
+
+const char *search_phase_name(int phase) {
+    if (phase < 0 || phase >= NB_SEARCH_PHASES)
+        return NULL;
+    return phase_names[phase];
+}
+
+void fprint_search_stats_json(FILE *stream, const SearchStats *stats) {
+    fprintf(stream,
+            "{\"seen\": %llu, \"expansions\": %llu, \"generations\": %llu, "
+            "\"duplicates\": %llu, \"iterations\": %llu, \"open_peak\": "
+            "%llu, \"closed_peak\": %llu, \"phase_seconds\": {",
+            (unsigned long long)stats->seen,
+            (unsigned long long)stats->expansions,
+            (unsigned long long)stats->generations,
+            (unsigned long long)stats->duplicates,
+            (unsigned long long)stats->iterations,
+            (unsigned long long)stats->open_peak,
+            (unsigned long long)stats->closed_peak);
+    for (int i = 0; i < NB_SEARCH_PHASES; i++) {
+        fprintf(stream, "%s\"%s\": %.6f", i == 0 ? "" : ", ", phase_names[i],
+                stats->phase_seconds[i]);
+    }
+    fprintf(stream, "}}");
+}
@@ -0,0 +1,127 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for Search statistics
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef SEARCH_STATS_H
+#define SEARCH_STATS_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the phases of a search timed by its SearchStats: allocating its
+ * structures, searching, then rebuilding the path found.
+ */
+#define SEARCH_PHASE_SETUP 0
+#define SEARCH_PHASE_SEARCH 1
+#define SEARCH_PHASE_PATH 2
+#define NB_SEARCH_PHASES 3
+
+/**
+ * Defines the phase of a search whose time is not recorded.
+ */
+#define NO_SEARCH_PHASE -1
+
+/**
+ * @struct SearchStats
+ * @brief Counters and timings of a search.
+ *
+ * seen counts the nodes taken from the open list, or visited by the last
+ * pass of an IDA* search, expansions those whose successors were generated.
+ * generations counts the successors, duplicates those pruned as already
+ * reached. iterations counts the depth or threshold iterations of the
+ * iterative searches.
+ * open_peak and closed_peak are the largest sizes of the open and closed
+ * lists; for an IDA* search the open list is the path being explored. The
+ * time of each phase is measured with a monotonic clock.
+ */
+typedef struct s_search_stats {
+    uint64_t seen;
+    uint64_t expansions;
+    uint64_t generations;
+    uint64_t duplicates;
+    uint64_t iterations;
+    uint64_t open_peak;
+    uint64_t closed_peak;
+    double phase_seconds[NB_SEARCH_PHASES];
+    int phase;
+    struct timespec phase_start;
+} SearchStats;
+
+/*
+ * The searches record their statistics through these macros only. Unless
+ * SEARCH_STATS is defined they compile to nothing, leaving no counter in the
+ * hot loops, and the statistics stay at 0. The only exception is the
+ * expansions of the parallel searches, which their threads count anyway to
+ * report their node rate.
+ */
+#ifdef SEARCH_STATS
+#define STATS_ADD(stats, counter, value) ((stats)->counter += (value))
+#define STATS_PEAK(stats, counter, value)                                      \
+    do {                                                                       \
+        uint64_t peak_value = (value);                                         \
+        if (peak_value > (stats)->counter)                                     \
+            (stats)->counter = peak_value;                                     \
+    } while (0)
+#define STATS_PHASE(stats, phase) enter_search_phase((stats), (phase))
+#else
+#define STATS_ADD(stats, counter, value) ((void)0)
+#define STATS_PEAK(stats, counter, value) ((void)0)
+#define STATS_PHASE(stats, phase) ((void)0)
+#endif
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initializes a SearchStats object, with every counter and timing at 0.
+ *
+ * @param stats The SearchStats object to initialize.
+ */
+void init_search_stats(SearchStats *stats);
+
+/**
+ * Ends the current phase of a search, adding its time to the phase, and
+ * starts another one.
+ *
+ * @param stats The statistics of the search.
+ * @param phase The phase to start, or NO_SEARCH_PHASE.
+ */
+void enter_search_phase(SearchStats *stats, int phase);
+
+/**
+ * Adds the statistics of a search to others, e.g. those of the threads of a
+ * parallel search or of the instances of a batch. The peaks add up when the
+ * searches ran at the same time, their lists existing together, and the
+ * largest one is kept when they ran one after the other.
+ *
+ * @param stats The statistics to add to.
+ * @param other The statistics to add.
+ * @param concurrent True if the searches ran at the same time.
+ */
+void merge_search_stats(SearchStats *stats, const SearchStats *other,
+                        bool concurrent);
+
+/**
+ * Returns the name of a phase of a search.
+ *
+ * @param phase The phase.
+ * @return The name of the phase, or NULL if the phase is invalid.
+ */
+const char *search_phase_name(int phase);
+
+/**
+ * Prints the statistics of a search as a JSON object, on one line.
+ *
+ * @param stream The stream to print to.
+ * @param stats The statistics to print.
+ */
+void fprint_search_stats_json(FILE *stream, const SearchStats *stats);
+
+#endif // SEARCH_STATS_H
@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of the algorithm Solver
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "solver.h"
+#include "algorithms.h"
+#include "distance_table.h"
+#include "pattern_database.h"
+#include <stdbool.h>
+
+/*-----------------------------------------------------------------*/
+
+static const char *algorithm_names[NB_ALGORITHMS] = {
+    "depth first search",
+    "iterative deepening",
+    "misplaced cubes heuristic",
+    "Manhattan distance heuristic",
+    "A* with misplaced cubes heuristic",
+    "A* with Manhattan distance heuristic",
+    "IDA* with misplaced cubes heuristic",
+    "IDA* with Manhattan distance heuristic",
+    "breadth first search",
+    "bidirectional breadth first search",
+    "IDA* with pattern database heuristic",
+    "parallel IDA* with Manhattan distance heuristic",
+    "parallel IDA* with pattern database heuristic",
+    "HDA* with Manhattan distance heuristic",
+    "HDA* with pattern database heuristic",
+    "optimal lookup in the distance table",
+    "external memory breadth first search",
+};
+
+const char *algorithm_name(int algorithm) {
+    if (algorithm < 0 || algorithm >= NB_ALGORITHMS)
+        return NULL;
+    return algorithm_names[algorithm];
+}
+
+bool is_parallel_algorithm(int algorithm) {
+    return algorithm >= 11 && algorithm <= 14;
+}
+
+bool is_optimal_algorithm(int algorithm) {
+    // The breadth first searches, the lookup and the pattern database
+    // heuristic, which is admissible
+    return algorithm == 8 || algorithm == 9 || algorithm == 10 ||
+           algorithm == 12 || algorithm == 14 || algorithm == 15 ||
+           algorithm == 16;
+}
+
+bool uses_transposition_table(int algorithm) {
+    return algorithm == 6 || algorithm == 7 || algorithm == 10 ||
+           algorithm == 11 || algorithm == 12;
+}
+
+void prepare_algorithm(int algorithm) {
+    if (algorithm == 10 || algorithm == 12 || algorithm == 14)
+        load_pattern_database(PATTERN_DATABASE_FILE);
+    else if (algorithm == 15)
+        load_distance_table(DISTANCE_TABLE_FILE);
+}
+
+void release_algorithm(int algorithm) {
+    if (algorithm == 10 || algorithm == 12 || algorithm == 14)
+        unload_pattern_database();
+    else if (algorithm == 15)
+        unload_distance_table();
+}
+
+bool solve(int algorithm, State *current, States *path, int step_cost,
+           int nb_threads, SearchStats *stats) {
+    switch (algorithm) {
+    case 0:
+        return depth_first_search(current, path, stats);
+    case 1:
+        return iterative_deepening(current, path, stats);
+    case 2:
+        return iterative_deepening_with_heuristic(current, path,
+                                                  misplaced_cubes, step_cost,
+                                                  stats);
+    case 3:
+        return iterative_deepening_with_heuristic(
+            current, path, manhattan_distance, step_cost, stats);
+    case 4:
+        return a_star(current, path, misplaced_cubes, step_cost, stats);
+    case 5:
+        return a_star(current, path, manhattan_distance, step_cost, stats);
+    case 6:
+        return ida_star(current, path, misplaced_cubes, step_cost, stats);
+    case 7:
+        return ida_star(current, path, manhattan_distance, step_cost, stats);
+    case 8:
+        return breadth_first_search(current, path, stats);
+    case 9:
+        return bidirectional_search(current, path, stats);
+    case 10:
+        return ida_star(current, path, pattern_database, step_cost, stats);
+    case 11:
+        return parallel_ida_star(current, path, manhattan_distance, step_cost,
+                                 nb_threads, stats);
+    case 12:
+        return parallel_ida_star(current, path, pattern_database, step_cost,
+                                 nb_threads, stats);
+    case 13:
+        return hda_star(current, path, manhattan_distance, step_cost,
+                        nb_threads, stats);
+    case 14:
+        return hda_star(current, path, pattern_database, step_cost, nb_threads,
+                        stats);
+    case 15:
+        return distance_table_search(current, path, stats);
+    case 16:
+        return external_breadth_first_search(current, path, stats);
+    default:
+        return false;
+    }
+}
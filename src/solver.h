@@ -0,0 +1,88 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for the algorithm Solver
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef SOLVER_H
+#define SOLVER_H
+#include "search_stats.h"
+#include "state.h"
+#include <stdbool.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the number of algorithms that can be selected by id.
+ */
+#define NB_ALGORITHMS 17
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Returns the description of an algorithm.
+ *
+ * @param algorithm The id of the algorithm.
+ * @return The description, or NULL if the id is invalid.
+ */
+const char *algorithm_name(int algorithm);
+
+/**
+ * Checks if an algorithm runs each search on several threads.
+ *
+ * @param algorithm The id of the algorithm.
+ * @return True if the algorithm is parallel, false otherwise.
+ */
+bool is_parallel_algorithm(int algorithm);
+
+/**
+ * Checks if an algorithm always finds a shortest path.
+ *
+ * @param algorithm The id of the algorithm.
+ * @return True if the algorithm is optimal, false otherwise.
+ */
+bool is_optimal_algorithm(int algorithm);
+
+/**
+ * Checks if an algorithm runs IDA* searches, which use a transposition table
+ * when set_ida_star_table_size() gives them one.
+ *
+ * @param algorithm The id of the algorithm.
+ * @return True if the algorithm uses the transposition table, false
+ * otherwise.
+ */
+bool uses_transposition_table(int algorithm);
+
+/**
+ * Loads the tables an algorithm depends on. Must be called before solving
+ * with the algorithm, from a single thread.
+ *
+ * @param algorithm The id of the algorithm.
+ */
+void prepare_algorithm(int algorithm);
+
+/**
+ * Releases the tables loaded by prepare_algorithm().
+ *
+ * @param algorithm The id of the algorithm.
+ */
+void release_algorithm(int algorithm);
+
+/**
+ * Solves an instance with an algorithm. Safe to call from several threads
+ * at once.
+ *
+ * @param algorithm The id of the algorithm.
+ * @param current The current state.
+ * @param path The path to the goal state.
+ * @param step_cost The cost of each step.
+ * @param nb_threads The number of threads of a parallel algorithm.
+ * @param stats The statistics of the search, added to.
+ * @return True if the goal state is found, false otherwise.
+ */
+bool solve(int algorithm, State *current, States *path, int step_cost,
+           int nb_threads, SearchStats *stats);
+
+#endif // SOLVER_H
@@ -0,0 +1,87 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for the goal rule and heuristic costs of a column
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef COLUMN_COSTS_H
+#define COLUMN_COSTS_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * The goal test and both heuristics sum a term per column, the same for the
+ * State and for the grids of every configuration. Each column is given by
+ * its cells from the bottom up, its height and the capacity of the columns
+ * of its puzzle; the cells above the height are 0.
+ */
+
+/**
+ * Returns the number of misplaced cubes of a column, counting the column
+ * itself when it is neither empty nor full, and each block not right above
+ * the next larger one.
+ *
+ * @param column The cells of the column, from the bottom up.
+ * @param height The number of blocks of the column.
+ * @param capacity The number of cells of a column.
+ * @return The number of misplaced cubes of the column.
+ */
+static inline int misplaced_cubes_of_column(const uint8_t column[], int height,
+                                            int capacity) {
+    int misplaced = height != 0 && height != capacity;
+    for (int j = 0; j < capacity - 1; j++) {
+        if (column[j] - column[j + 1] != 1 && column[j] != 0)
+            misplaced++;
+    }
+    return misplaced;
+}
+
+/**
+ * Checks if a column follows the goal rule: it is empty or full, with each
+ * block right above the next larger one. A state is a goal state when all
+ * its columns are.
+ *
+ * @param column The cells of the column, from the bottom up.
+ * @param height The number of blocks of the column.
+ * @param capacity The number of cells of a column.
+ * @return True if the column has no misplaced cube.
+ */
+static inline bool is_goal_column(const uint8_t column[], int height,
+                                  int capacity) {
+    return misplaced_cubes_of_column(column, height, capacity) == 0;
+}
+
+/**
+ * Returns the Manhattan distance of a column, with the same terms as
+ * misplaced_cubes_of_column() but each misplaced block counting the distance
+ * to its position in the goal state where block b is at level
+ * (b - 1) % capacity of column (b - 1) / capacity.
+ *
+ * @param column The cells of the column, from the bottom up.
+ * @param height The number of blocks of the column.
+ * @param index The index of the column.
+ * @param capacity The number of cells of a column.
+ * @return The Manhattan distance of the column.
+ */
+static inline int manhattan_distance_of_column(const uint8_t column[],
+                                               int height, int index,
+                                               int capacity) {
+    int distance = height != 0 && height != capacity;
+    for (int j = 0; j < capacity - 1; j++) {
+        int element = column[j];
+        if (element != 0) {
+            int goal_i = (element - 1) / capacity;
+            int goal_j = (element - 1) % capacity;
+            if (element - column[j + 1] != 1)
+                distance += abs(index - goal_i) + abs(j - goal_j);
+        }
+    }
+    return distance;
+}
+
+#endif // COLUMN_COSTS_H
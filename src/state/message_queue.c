@@ -0,0 +1,34 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation for Message queues
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "message_queue.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+/*-----------------------------------------------------------------*/
+
+void init_message_queue(MessageQueue *queue) {
+    atomic_init(&queue->head, NULL);
+}
+
+void push_message_block(MessageQueue *queue, MessageBlock *block) {
+    MessageBlock *head =
+        atomic_load_explicit(&queue->head, memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(
+        &queue->head, &head, block, memory_order_release,
+        memory_order_relaxed));
+}
+
+MessageBlock *take_message_blocks(MessageQueue *queue) {
+    // Skip the swap when the queue is empty, the common case of a poll
+    if (atomic_load_explicit(&queue->head, memory_order_relaxed) == NULL)
+        return NULL;
+    return atomic_exchange_explicit(&queue->head, NULL, memory_order_acquire);
+}
@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for Message queues
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+#include "state.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the number of messages sent together in a MessageBlock.
+ */
+#define MESSAGE_BLOCK_SIZE 64
+
+/**
+ * @struct StateMessage
+ * @brief A state generated by a thread for the thread that owns it.
+ */
+typedef struct s_state_message {
+    PackedState state;
+    uint32_t parent;
+    int depth;
+} StateMessage;
+
+/**
+ * @struct MessageBlock
+ * @brief A batch of messages, linked to the next block of a MessageQueue.
+ */
+typedef struct s_message_block {
+    struct s_message_block *next;
+    int size;
+    StateMessage messages[MESSAGE_BLOCK_SIZE];
+} MessageBlock;
+
+/**
+ * @struct MessageQueue
+ * @brief Lock-free queue of message blocks with many producers and a single
+ * consumer.
+ *
+ * Producers push blocks on a list with a compare-and-swap on its head, and
+ * the consumer takes the whole list at once by swapping the head with NULL.
+ * As the consumer never takes a single block, no block can be seen twice and
+ * the queue is free of the ABA problem.
+ */
+typedef struct s_message_queue {
+    _Atomic(MessageBlock *) head;
+} MessageQueue;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initializes an empty MessageQueue.
+ *
+ * @param queue The MessageQueue object to initialize.
+ */
+void init_message_queue(MessageQueue *queue);
+
+/**
+ * Pushes a block on a MessageQueue. Safe to call from several threads at
+ * once.
+ *
+ * @param queue The MessageQueue object.
+ * @param block The block, owned by the consumer from now on.
+ */
+void push_message_block(MessageQueue *queue, MessageBlock *block);
+
+/**
+ * Takes every block of a MessageQueue. Must only be called by the consumer.
+ *
+ * @param queue The MessageQueue object.
+ * @return The blocks linked by their next field, most recent first, or NULL
+ * if the queue is empty.
+ */
+MessageBlock *take_message_blocks(MessageQueue *queue);
+
+#endif // MESSAGE_QUEUE_H
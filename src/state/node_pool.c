@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation for search Nodes
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "node_pool.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*-----------------------------------------------------------------*/
+
+void init_node_pool(NodePool *pool) {
+    pool->nodes = NULL;
+    pool->size = 0;
+    pool->capacity = 0;
+}
+
+void reset_node_pool(NodePool *pool) {
+    pool->size = 0;
+}
+
+void free_node_pool(NodePool *pool) {
+    free(pool->nodes);
+    init_node_pool(pool);
+}
+
+NodeId new_node(NodePool *pool, PackedState state, NodeId parent, int depth) {
+    if (pool->size == pool->capacity) {
+        pool->capacity = pool->capacity == 0 ? NODE_POOL_INITIAL_CAPACITY
+                                             : pool->capacity * 2;
+        pool->nodes = realloc(pool->nodes, pool->capacity * sizeof(Node));
+        assert(pool->nodes != NULL);
+    }
+    assert(pool->size < NO_PARENT);
+    Node *node = &pool->nodes[pool->size];
+    node->state = state;
+    node->parent = parent;
+    node->depth = depth;
+    return pool->size++;
+}
+
+void init_node_stack(NodeStack *stack) {
+    stack->ids = NULL;
+    stack->size = 0;
+    stack->capacity = 0;
+}
+
+void free_node_stack(NodeStack *stack) {
+    free(stack->ids);
+    init_node_stack(stack);
+}
+
+void push_node(NodeStack *stack, NodeId id) {
+    if (stack->size == stack->capacity) {
+        stack->capacity = stack->capacity == 0 ? NODE_POOL_INITIAL_CAPACITY
+                                               : stack->capacity * 2;
+        stack->ids = realloc(stack->ids, stack->capacity * sizeof(NodeId));
+        assert(stack->ids != NULL);
+    }
+    stack->ids[stack->size++] = id;
+}
+
+NodeId pop_node(NodeStack *stack) {
+    assert(stack->size > 0);
+    return stack->ids[--stack->size];
+}
@@ -0,0 +1,141 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for search Nodes
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+#include "state.h"
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initial number of nodes of a NodePool or NodeStack.
+ */
+#define NODE_POOL_INITIAL_CAPACITY 1024
+
+/**
+ * Defines the parent of the root node of a search.
+ */
+#define NO_PARENT UINT32_MAX
+
+/**
+ * @typedef NodeId
+ * @brief Index of a Node in its NodePool.
+ */
+typedef uint32_t NodeId;
+
+/**
+ * @struct Node
+ * @brief A state reached by a search, with the node it was reached from.
+ */
+typedef struct s_node {
+    PackedState state;
+    NodeId parent;
+    int depth;
+} Node;
+
+/**
+ * @struct NodePool
+ * @brief Arena holding every node created by a search.
+ *
+ * Nodes are appended and never freed one by one: they reference their parent
+ * by index, so the pool can grow without invalidating them, and the whole
+ * search is released at once by reset_node_pool() or free_node_pool().
+ */
+typedef struct s_node_pool {
+    Node *nodes;
+    unsigned long long size;
+    unsigned long long capacity;
+} NodePool;
+
+/**
+ * @struct NodeStack
+ * @brief LIFO stack of node indices, used as a search frontier.
+ */
+typedef struct s_node_stack {
+    NodeId *ids;
+    unsigned long long size;
+    unsigned long long capacity;
+} NodeStack;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initializes an empty NodePool.
+ *
+ * @param pool The NodePool object to initialize.
+ */
+void init_node_pool(NodePool *pool);
+
+/**
+ * Releases every node of a NodePool, keeping its memory for the next search.
+ *
+ * @param pool The NodePool object to reset.
+ */
+void reset_node_pool(NodePool *pool);
+
+/**
+ * Releases the memory held by a NodePool.
+ *
+ * @param pool The NodePool object to free.
+ */
+void free_node_pool(NodePool *pool);
+
+/**
+ * Appends a node to a NodePool.
+ *
+ * @param pool The NodePool object.
+ * @param state The packed state of the node.
+ * @param parent The index of the parent node, or NO_PARENT for a root.
+ * @param depth The depth of the node.
+ * @return The index of the new node.
+ */
+NodeId new_node(NodePool *pool, PackedState state, NodeId parent, int depth);
+
+/**
+ * Returns a node of a NodePool. The pointer is invalidated by new_node().
+ *
+ * @param pool The NodePool object.
+ * @param id The index of the node.
+ * @return A pointer to the node.
+ */
+static inline Node *get_node(NodePool *pool, NodeId id) {
+    return &pool->nodes[id];
+}
+
+/**
+ * Initializes an empty NodeStack.
+ *
+ * @param stack The NodeStack object to initialize.
+ */
+void init_node_stack(NodeStack *stack);
+
+/**
+ * Releases the memory held by a NodeStack.
+ *
+ * @param stack The NodeStack object to free.
+ */
+void free_node_stack(NodeStack *stack);
+
+/**
+ * Pushes a node index onto a NodeStack.
+ *
+ * @param stack The NodeStack object.
+ * @param id The node index to push.
+ */
+void push_node(NodeStack *stack, NodeId id);
+
+/**
+ * Pops a node index from a NodeStack.
+ *
+ * @param stack The NodeStack object.
+ * @return The popped node index.
+ */
+NodeId pop_node(NodeStack *stack);
+
+#endif // NODE_POOL_H
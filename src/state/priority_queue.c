@@ -0,0 +1,133 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation for indexed Priority queues
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "priority_queue.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*-----------------------------------------------------------------*/
+
+static bool has_precedence(const PriorityQueue *queue, NodeId a, NodeId b) {
+    if (queue->priorities[a] != queue->priorities[b])
+        return queue->priorities[a] < queue->priorities[b];
+    return queue->depths[a] > queue->depths[b];
+}
+
+static void place(PriorityQueue *queue, unsigned long long position,
+                  NodeId id) {
+    queue->heap[position] = id;
+    queue->positions[id] = position;
+}
+
+static void sift_up(PriorityQueue *queue, unsigned long long position) {
+    NodeId id = queue->heap[position];
+    while (position > 0) {
+        unsigned long long parent = (position - 1) / 2;
+        if (!has_precedence(queue, id, queue->heap[parent]))
+            break;
+        place(queue, position, queue->heap[parent]);
+        position = parent;
+    }
+    place(queue, position, id);
+}
+
+static void sift_down(PriorityQueue *queue, unsigned long long position) {
+    NodeId id = queue->heap[position];
+    while (true) {
+        unsigned long long child = 2 * position + 1;
+        if (child >= queue->size)
+            break;
+        if (child + 1 < queue->size &&
+            has_precedence(queue, queue->heap[child + 1], queue->heap[child]))
+            child++;
+        if (!has_precedence(queue, queue->heap[child], id))
+            break;
+        place(queue, position, queue->heap[child]);
+        position = child;
+    }
+    place(queue, position, id);
+}
+
+/**
+ * Grows the per-node arrays so that they can be indexed by id.
+ */
+static void ensure_index(PriorityQueue *queue, NodeId id) {
+    if (id < queue->capacity)
+        return;
+    unsigned long long capacity =
+        queue->capacity == 0 ? NODE_POOL_INITIAL_CAPACITY : queue->capacity;
+    while (capacity <= id)
+        capacity *= 2;
+    queue->heap = realloc(queue->heap, capacity * sizeof(NodeId));
+    queue->priorities = realloc(queue->priorities, capacity * sizeof(double));
+    queue->depths = realloc(queue->depths, capacity * sizeof(int));
+    queue->positions = realloc(queue->positions, capacity * sizeof(uint32_t));
+    assert(queue->heap != NULL && queue->priorities != NULL &&
+           queue->depths != NULL && queue->positions != NULL);
+    for (unsigned long long i = queue->capacity; i < capacity; i++) {
+        queue->positions[i] = NOT_IN_QUEUE;
+    }
+    queue->capacity = capacity;
+}
+
+void init_priority_queue(PriorityQueue *queue) {
+    queue->heap = NULL;
+    queue->size = 0;
+    queue->priorities = NULL;
+    queue->depths = NULL;
+    queue->positions = NULL;
+    queue->capacity = 0;
+}
+
+void free_priority_queue(PriorityQueue *queue) {
+    free(queue->heap);
+    free(queue->priorities);
+    free(queue->depths);
+    free(queue->positions);
+    init_priority_queue(queue);
+}
+
+void insert_in_queue(PriorityQueue *queue, NodeId id, double priority,
+                     int depth) {
+    ensure_index(queue, id);
+    assert(queue->positions[id] == NOT_IN_QUEUE);
+    queue->priorities[id] = priority;
+    queue->depths[id] = depth;
+    place(queue, queue->size, id);
+    queue->size++;
+    sift_up(queue, queue->size - 1);
+}
+
+void decrease_priority(PriorityQueue *queue, NodeId id, double priority,
+                       int depth) {
+    assert(is_node_in_queue(queue, id) && priority <= queue->priorities[id]);
+    queue->priorities[id] = priority;
+    queue->depths[id] = depth;
+    sift_up(queue, queue->positions[id]);
+}
+
+NodeId pop_min_priority(PriorityQueue *queue) {
+    assert(queue->size > 0);
+    NodeId min = queue->heap[0];
+    queue->positions[min] = NOT_IN_QUEUE;
+    queue->size--;
+    if (queue->size > 0) {
+        place(queue, 0, queue->heap[queue->size]);
+        sift_down(queue, 0);
+    }
+    return min;
+}
+
+double min_priority(const PriorityQueue *queue) {
+    assert(queue->size > 0);
+    return queue->priorities[queue->heap[0]];
+}
+
+bool is_node_in_queue(const PriorityQueue *queue, NodeId id) {
+    return id < queue->capacity && queue->positions[id] != NOT_IN_QUEUE;
+}
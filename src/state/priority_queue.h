@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for indexed Priority queues
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+#include "node_pool.h"
+#include <stdbool.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the position of a node that is not in a PriorityQueue.
+ */
+#define NOT_IN_QUEUE UINT32_MAX
+
+/**
+ * @struct PriorityQueue
+ * @brief Indexed binary min-heap of node indices.
+ *
+ * The priority and heap position of each node are stored in arrays indexed by
+ * NodeId, so the priority of a queued node can be decreased in O(log n)
+ * without searching for it. Nodes with equal priorities are popped deepest
+ * first.
+ */
+typedef struct s_priority_queue {
+    NodeId *heap;
+    unsigned long long size;
+    double *priorities;
+    int *depths;
+    uint32_t *positions;
+    unsigned long long capacity;
+} PriorityQueue;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initializes an empty PriorityQueue.
+ *
+ * @param queue The PriorityQueue object to initialize.
+ */
+void init_priority_queue(PriorityQueue *queue);
+
+/**
+ * Releases the memory held by a PriorityQueue.
+ *
+ * @param queue The PriorityQueue object to free.
+ */
+void free_priority_queue(PriorityQueue *queue);
+
+/**
+ * Inserts a node in a PriorityQueue.
+ *
+ * @param queue The PriorityQueue object.
+ * @param id The index of the node, not already in the queue.
+ * @param priority The priority of the node, lowest first.
+ * @param depth The depth of the node, used to break ties.
+ */
+void insert_in_queue(PriorityQueue *queue, NodeId id, double priority,
+                     int depth);
+
+/**
+ * Lowers the priority of a node of a PriorityQueue.
+ *
+ * @param queue The PriorityQueue object.
+ * @param id The index of the node, in the queue.
+ * @param priority The new priority, not greater than the current one.
+ * @param depth The new depth of the node.
+ */
+void decrease_priority(PriorityQueue *queue, NodeId id, double priority,
+                       int depth);
+
+/**
+ * Removes the node with the lowest priority from a PriorityQueue.
+ *
+ * @param queue The PriorityQueue object, not empty.
+ * @return The index of the removed node.
+ */
+NodeId pop_min_priority(PriorityQueue *queue);
+
+/**
+ * Returns the lowest priority of a PriorityQueue.
+ *
+ * @param queue The PriorityQueue object, not empty.
+ * @return The priority of the node that pop_min_priority() would remove.
+ */
+double min_priority(const PriorityQueue *queue);
+
+/**
+ * Checks if a node is in a PriorityQueue.
+ *
+ * @param queue The PriorityQueue object.
+ * @param id The index of the node.
+ * @return true if the node is in the queue, false otherwise.
+ */
+bool is_node_in_queue(const PriorityQueue *queue, NodeId id);
+
+#endif // PRIORITY_QUEUE_H
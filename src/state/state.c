@@ -7,11 +7,48 @@
 /*-----------------------------------------------------------------*/
 
 #include "state.h"
+#include "column_costs.h"
+#include "state_simd.h"
 #include <assert.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <threads.h>
+
+/*-----------------------------------------------------------------*/
+
+_Static_assert(STATE_HEIGHT <= 3 && NB_HEIGHT_SIGNATURES <= 256,
+               "a height signature must fit the successors of HeightMoves");
+
+static once_flag height_moves_once = ONCE_FLAG_INIT;
+static HeightMoves height_moves_table[NB_HEIGHT_SIGNATURES];
+
+static void init_height_moves(void) {
+    for (int signature = 0; signature < NB_HEIGHT_SIGNATURES; signature++) {
+        HeightMoves *moves = &height_moves_table[signature];
+        moves->nb_movement = 0;
+        for (int i = 0; i < STATE_WIDTH; i++) {
+            if (((signature >> (2 * i)) & 0x3) == 0)
+                continue;
+            for (int j = 0; j < STATE_WIDTH; j++) {
+                if (i == j || ((signature >> (2 * j)) & 0x3) == STATE_HEIGHT)
+                    continue;
+                moves->movements[moves->nb_movement].from = i;
+                moves->movements[moves->nb_movement].to = j;
+                moves->successors[moves->nb_movement] =
+                    signature - (1 << (2 * i)) + (1 << (2 * j));
+                moves->nb_movement++;
+            }
+        }
+    }
+}
+
+const HeightMoves *height_moves(unsigned int signature) {
+    call_once(&height_moves_once, init_height_moves);
+    assert(signature < NB_HEIGHT_SIGNATURES);
+    return &height_moves_table[signature];
+}
 
 /*-----------------------------------------------------------------*/
 
@@ -25,11 +62,31 @@ void init_movement(Movement *movement) {
 
 void init_states(States *states) {
     states->size = 0;
+    states->capacity = 0;
     states->stack = NULL;
 }
 
-void push_state(States *states, State *state) {
-    states->stack = realloc(states->stack, (states->size + 1) * sizeof(State));
+void free_states(States *states) {
+    free(states->stack);
+    init_states(states);
+}
+
+void clear_states(States *states) {
+    states->size = 0;
+}
+
+void reserve_states(States *states, unsigned long long capacity) {
+    if (capacity <= states->capacity)
+        return;
+    states->stack = realloc(states->stack, capacity * sizeof(State));
+    assert(states->stack != NULL);
+    states->capacity = capacity;
+}
+
+void push_state(States *states, const State *state) {
+    if (states->size == states->capacity)
+        reserve_states(states,
+                       states->capacity == 0 ? 16 : states->capacity * 2);
     states->stack[states->size] = *state;
     states->size++;
 }
@@ -45,9 +102,9 @@ State *top_state(States *states) {
     return &states->stack[states->size - 1];
 }
 
-bool is_state_in_states(States states, State state) {
-    for (unsigned long long i = 0; i < states.size; i++) {
-        if (is_same_state(states.stack[i], state))
+bool is_state_in_states(const States *states, const State *state) {
+    for (unsigned long long i = 0; i < states->size; i++) {
+        if (is_same_state(&states->stack[i], state))
             return true;
     }
     return false;
@@ -60,32 +117,36 @@ State copy_state(State *state) {
     return copy;
 }
 
-bool is_same_state(State s1, State s2) {
+bool is_same_state(const State *s1, const State *s2) {
+#ifdef STATE_SIMD
+    return is_same_grid_simd(s1, s2);
+#else
     for (int i = 0; i < STATE_WIDTH; i++) {
-        if (s1.nb_element[i] != s2.nb_element[i])
+        if (s1->nb_element[i] != s2->nb_element[i])
             return false;
         for (int j = 0; j < STATE_HEIGHT; j++) {
-            if (s1.state[i][j] != s2.state[i][j])
+            if (s1->state[i][j] != s2->state[i][j])
                 return false;
         }
     }
     return true;
+#endif
 }
 
-bool is_goal_state(State state) {
+bool is_goal_state(const State *state) {
+#ifdef STATE_SIMD
+    return is_goal_grid_simd(state);
+#else
     for (int i = 0; i < STATE_WIDTH; i++) {
-        if (state.nb_element[i] != 0 && state.nb_element[i] != 3)
+        if (!is_goal_column(state->state[i], state->nb_element[i],
+                            STATE_HEIGHT))
             return false;
-        for (int j = 0; j < STATE_HEIGHT - 1; j++) {
-            if (state.state[i][j] - state.state[i][j + 1] != 1 &&
-                state.state[i][j] != 0)
-                return false;
-        }
     }
     return true;
+#endif
 }
 
-int sum_elements(State *state) {
+int sum_elements(const State *state) {
     int sum = 0;
     for (int i = 0; i < STATE_WIDTH; i++) {
         sum += state->nb_element[i];
@@ -94,8 +155,10 @@ int sum_elements(State *state) {
 }
 
 bool add_element(State *state, uint8_t element, uint8_t index) {
-    assert(element <= 9 && element >= 0 && index >= 0 && index < STATE_WIDTH);
-    if (state->nb_element[index] == STATE_HEIGHT || sum_elements(state) >= 9)
+    assert(element <= NB_BLOCKS && element >= 0 && index >= 0 &&
+           index < STATE_WIDTH);
+    if (state->nb_element[index] == STATE_HEIGHT ||
+        sum_elements(state) >= NB_BLOCKS)
         return false;
     if (element != 0) {
         state->state[index][state->nb_element[index]] = element;
@@ -113,58 +176,211 @@ void array_to_state(State *state, uint8_t array[]) {
     }
 }
 
-bool is_movement_valid(State state, Movement movement) {
-    assert(sum_elements(&state) == 9);
-    return state.nb_element[movement.to] != 3 &&
-           state.nb_element[movement.from] != 0;
+bool parse_state(const char *string, State *state) {
+    init_state(state);
+    int seen = 0;
+    const char *cursor = string;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        while (*cursor == ' ' || *cursor == '\t')
+            cursor++;
+        for (int j = 0; j < STATE_HEIGHT; j++, cursor++) {
+            int element = *cursor - '0';
+            if (element < 0 || element > NB_BLOCKS ||
+                (element != 0 && (seen >> element & 1)) ||
+                (element != 0 && state->nb_element[i] != j))
+                return false;
+            seen |= element != 0 ? 1 << element : 0;
+            add_element(state, element, i);
+        }
+    }
+    while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' ||
+           *cursor == '\n')
+        cursor++;
+    return *cursor == '\0' && seen == (1 << (NB_BLOCKS + 1)) - 2;
 }
 
-Movement *possible_movements(State state, int *nb_movement) {
-    Movement *movements = calloc(STATE_WIDTH * STATE_HEIGHT, sizeof(Movement));
+Movement movement_between_states(const State *state, const State *successor) {
     Movement movement;
-    *nb_movement = 0;
+    init_movement(&movement);
     for (int i = 0; i < STATE_WIDTH; i++) {
-        for (int j = 0; j < STATE_WIDTH; j++) {
-            init_movement(&movement);
-            if (i != j) {
-                movement.from = i;
-                movement.to = j;
-                if (is_movement_valid(state, movement)) {
-                    movements[*nb_movement] = movement;
-                    (*nb_movement)++;
-                }
-            }
-        }
+        if (successor->nb_element[i] < state->nb_element[i])
+            movement.from = i;
+        else if (successor->nb_element[i] > state->nb_element[i])
+            movement.to = i;
     }
-    return movements;
+    assert(movement.from != movement.to);
+    return movement;
+}
+
+bool is_movement_valid(const State *state, Movement movement) {
+    assert(sum_elements(state) == NB_BLOCKS);
+    return movement.from != movement.to &&
+           state->nb_element[movement.to] != STATE_HEIGHT &&
+           state->nb_element[movement.from] != 0;
 }
 
-States possible_states(State state) {
-    int nb_states;
-    Movement *movements = possible_movements(state, &nb_states);
-    States states;
-    init_states(&states);
+int possible_movements(const State *state, Movement movements[]) {
+    unsigned int signature = 0;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        signature |= state->nb_element[i] << (2 * i);
+    }
+    const HeightMoves *moves = height_moves(signature);
+    memcpy(movements, moves->movements,
+           moves->nb_movement * sizeof(Movement));
+    return moves->nb_movement;
+}
+
+int possible_states(State *state, State successors[]) {
+    Movement movements[MAX_MOVEMENTS];
+    int nb_states = possible_movements(state, movements);
     for (int i = 0; i < nb_states; i++) {
-        push_state(&states, &state);
-        apply_movement_to_state(&states.stack[i], movements[i]);
-        states.stack[i].predecessor = malloc(sizeof(State));
-        if (states.stack[i].predecessor != NULL) {
-            *(states.stack[i].predecessor) = copy_state(&state);
+        successors[i] = *state;
+        apply_movement_to_state(&successors[i], movements[i]);
+        successors[i].predecessor = state;
+        successors[i].depth = state->depth + 1;
+    }
+    return nb_states;
+}
+
+/*-----------------------------------------------------------------*/
+
+PackedState pack_state(const State *state) {
+    PackedState packed = 0;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        for (int j = 0; j < state->nb_element[i]; j++) {
+            packed |= (PackedState)state->state[i][j]
+                      << PACKED_CELL_OFFSET(i, j);
         }
+        packed |= (PackedState)state->nb_element[i]
+                  << (PACKED_HEIGHTS_OFFSET + 2 * i);
     }
-    free(movements);
-    return states;
+    return packed;
 }
 
-void apply_movement_to_state(State *state, Movement movement) {
-    assert(is_movement_valid(*state, movement));
-    state->state[movement.to][state->nb_element[movement.to]] =
-        state->state[movement.from][state->nb_element[movement.from] - 1];
-    state->state[movement.from][state->nb_element[movement.from] - 1] = 0;
-    state->nb_element[movement.from]--;
-    state->nb_element[movement.to]++;
+void unpack_state(PackedState packed, State *state) {
+    init_state(state);
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        state->nb_element[i] = packed_height(packed, i);
+        for (int j = 0; j < state->nb_element[i]; j++) {
+            state->state[i][j] = (packed >> PACKED_CELL_OFFSET(i, j)) & 0xF;
+        }
+    }
+}
+
+bool is_packed_goal_state(PackedState packed) {
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        int height = packed_height(packed, i);
+        if (height == 0)
+            continue;
+        if (height != STATE_HEIGHT)
+            return false;
+        for (int j = 0; j < STATE_HEIGHT - 1; j++) {
+            int below = (packed >> PACKED_CELL_OFFSET(i, j)) & 0xF;
+            int above = (packed >> PACKED_CELL_OFFSET(i, j + 1)) & 0xF;
+            if (below - above != 1)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Places the ordered stacks from stack onwards in the free columns of packed,
+ * appending every completed goal state to goals.
+ */
+static void place_goal_stacks(PackedState packed, int stack,
+                              PackedState *goals, int *nb_goal) {
+    if (stack * STATE_HEIGHT == NB_BLOCKS) {
+        goals[(*nb_goal)++] = packed;
+        return;
+    }
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        if (packed_height(packed, i) != 0)
+            continue;
+        PackedState column = packed;
+        for (int j = 0; j < STATE_HEIGHT; j++) {
+            PackedState element = (stack + 1) * STATE_HEIGHT - j;
+            column |= element << PACKED_CELL_OFFSET(i, j);
+        }
+        column |= (PackedState)STATE_HEIGHT
+                  << (PACKED_HEIGHTS_OFFSET + 2 * i);
+        place_goal_stacks(column, stack + 1, goals, nb_goal);
+    }
+}
+
+PackedState *packed_goal_states(int *nb_goal) {
+    // At most STATE_WIDTH! ways to place the stacks in the columns
+    int max_goal = 1;
+    for (int i = 2; i <= STATE_WIDTH; i++) {
+        max_goal *= i;
+    }
+    PackedState *goals = calloc(max_goal, sizeof(PackedState));
+    *nb_goal = 0;
+    place_goal_stacks(0, 0, goals, nb_goal);
+    return goals;
 }
 
+int packed_possible_movements(PackedState packed, Movement movements[]) {
+    const HeightMoves *moves = height_moves(height_signature(packed));
+    memcpy(movements, moves->movements,
+           moves->nb_movement * sizeof(Movement));
+    return moves->nb_movement;
+}
+
+PackedState apply_movement_to_packed_state(PackedState packed,
+                                           Movement movement) {
+    int from_height = packed_height(packed, movement.from);
+    int to_height = packed_height(packed, movement.to);
+    assert(from_height > 0 && to_height < STATE_HEIGHT);
+    int from_offset = PACKED_CELL_OFFSET(movement.from, from_height - 1);
+    PackedState element = (packed >> from_offset) & 0xF;
+    packed &= ~((PackedState)0xF << from_offset);
+    packed |= element << PACKED_CELL_OFFSET(movement.to, to_height);
+    packed -= (PackedState)1 << (PACKED_HEIGHTS_OFFSET + 2 * movement.from);
+    packed += (PackedState)1 << (PACKED_HEIGHTS_OFFSET + 2 * movement.to);
+    return packed;
+}
+
+PackedState canonical_packed_state(PackedState packed) {
+    // A column and its height as one key, ordered by height first
+    const int column_bits = 4 * STATE_HEIGHT;
+    const PackedState column_mask = ((PackedState)1 << column_bits) - 1;
+    PackedState columns[STATE_WIDTH];
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        PackedState column =
+            ((packed >> PACKED_CELL_OFFSET(i, 0)) & column_mask) |
+            (PackedState)packed_height(packed, i) << column_bits;
+        int j = i;
+        for (; j > 0 && columns[j - 1] < column; j--) {
+            columns[j] = columns[j - 1];
+        }
+        columns[j] = column;
+    }
+    PackedState canonical = 0;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        canonical |= (columns[i] & column_mask) << PACKED_CELL_OFFSET(i, 0);
+        canonical |= (columns[i] >> column_bits)
+                     << (PACKED_HEIGHTS_OFFSET + 2 * i);
+    }
+    return canonical;
+}
+
+bool canonical_movement(PackedState packed, PackedState successor,
+                        Movement *movement) {
+    const HeightMoves *moves = height_moves(height_signature(packed));
+    for (int i = 0; i < moves->nb_movement; i++) {
+        PackedState child =
+            apply_movement_to_packed_state(packed, moves->movements[i]);
+        if (canonical_packed_state(child) == successor) {
+            *movement = moves->movements[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/*-----------------------------------------------------------------*/
+
 void state_to_string(State *s, char *buffer) {
     const char *blocks[4] = {"\u2585", "\u2583", "\u2584"};
     char *ptr = buffer;
@@ -214,9 +430,13 @@ void state_to_string(State *s, char *buffer) {
 }
 
 void print_state(State *s) {
+    fprint_state(stdout, s);
+}
+
+void fprint_state(FILE *stream, State *s) {
     char stateString[MAX_STATE_STRING_SIZE];
     state_to_string(s, stateString);
-    printf("%s", stateString);
+    fputs(stateString, stream);
 }
 
 void print_raw_state(State *s) {
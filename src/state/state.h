@@ -8,8 +8,10 @@
 
 #ifndef STATE_H
 #define STATE_H
+#include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #define ANSI_COLOR_BLUE "\x1b[34m"
 #define ANSI_COLOR_RED "\x1b[31m"
 #define ANSI_COLOR_YELLOW "\x1b[33m"
@@ -29,6 +31,16 @@
  */
 #define STATE_WIDTH 4
 
+/**
+ * Defines the number of blocks in a State, numbered from 1 to NB_BLOCKS.
+ */
+#define NB_BLOCKS 9
+
+/**
+ * Defines the maximum number of movements from a State.
+ */
+#define MAX_MOVEMENTS (STATE_WIDTH * (STATE_WIDTH - 1))
+
 /**
  * @struct State
  * @brief Represents a state with three octets.
@@ -52,9 +64,62 @@ typedef struct s_movement {
     uint8_t to;
 } Movement;
 
+/**
+ * @typedef PackedState
+ * @brief A State grid packed in a single machine word.
+ *
+ * Column i occupies the 12 bits starting at bit 12 * i, with one 4-bit cell
+ * per level from the bottom up. The height of column i is stored on 2 bits at
+ * bit 48 + 2 * i. The predecessor and depth fields of a State are not part of
+ * the packed form, so two states pack to the same word if and only if
+ * is_same_state() holds for them. A valid state never packs to 0.
+ */
+typedef uint64_t PackedState;
+
+/**
+ * Defines the bit offset of the column heights in a PackedState.
+ */
+#define PACKED_HEIGHTS_OFFSET (4 * STATE_WIDTH * STATE_HEIGHT)
+
+/**
+ * Defines the bit offset of a cell in a PackedState.
+ */
+#define PACKED_CELL_OFFSET(column, level)                                      \
+    (4 * ((column) * STATE_HEIGHT + (level)))
+
+/**
+ * Defines the number of height signatures, i.e. values of the heights field
+ * of a PackedState, valid or not.
+ */
+#define NB_HEIGHT_SIGNATURES (1 << (2 * STATE_WIDTH))
+
+/**
+ * @struct HeightMoves
+ * @brief The movements possible from every state with the same column
+ * heights.
+ *
+ * The valid movements of a state only depend on its height signature, the
+ * heights field of its PackedState. movements lists them in the order
+ * possible_movements() always used, and successors[i] is the height
+ * signature reached by movements[i].
+ */
+typedef struct s_height_moves {
+    int nb_movement;
+    Movement movements[MAX_MOVEMENTS];
+    uint8_t successors[MAX_MOVEMENTS];
+} HeightMoves;
+
+/**
+ * @struct States
+ * @brief Growable array of State objects, used as a stack.
+ *
+ * The capacity doubles when the array is full, so pushing is amortized O(1).
+ * Clearing the array keeps its memory for the next use.
+ */
 typedef struct s_states {
     State *stack;
     unsigned long long size;
+    unsigned long long capacity;
 } States;
 
 /*-----------------------------------------------------------------*/
@@ -74,19 +139,44 @@ void init_state(State *state);
 void init_movement(Movement *movement);
 
 /**
- * Initializes a States object by setting its size to 0 and its stack to NULL.
+ * Initializes a States object by setting its size and capacity to 0 and its
+ * stack to NULL.
  *
  * @param states The States object to initialize.
  */
 void init_states(States *states);
 
 /**
- * Pushes a State object onto the stack of a States object.
+ * Releases the memory held by a States object and resets it to an empty
+ * stack.
+ *
+ * @param states The States object to free.
+ */
+void free_states(States *states);
+
+/**
+ * Removes every State object of a States object, keeping its memory.
+ *
+ * @param states The States object to clear.
+ */
+void clear_states(States *states);
+
+/**
+ * Ensures a States object can hold a number of State objects without
+ * reallocating.
+ *
+ * @param states The States object.
+ * @param capacity The number of State objects to make room for.
+ */
+void reserve_states(States *states, unsigned long long capacity);
+
+/**
+ * Pushes a copy of a State object onto the stack of a States object.
  *
  * @param states The States object.
  * @param state The State object to push.
  */
-void push_state(States *states, State *state);
+void push_state(States *states, const State *state);
 
 /**
  * Pops a State object from the stack of a States object.
@@ -111,7 +201,7 @@ State *top_state(States *states);
  * @param state The State object to check.
  * @return true if the State object is present, false otherwise.
  */
-bool is_state_in_states(States states, State state);
+bool is_state_in_states(const States *states, const State *state);
 
 /**
  * Creates a copy of a State object.
@@ -128,7 +218,8 @@ State copy_state(State *state);
  * @param s2 The second State object.
  * @return true if the State objects are the same, false otherwise.
  */
-bool is_same_state(State s1, State s2);
+bool is_same_state(const State *s1, const State *s2);
+
 
 /**
  * Checks if a State object is a goal state.
@@ -136,7 +227,7 @@ bool is_same_state(State s1, State s2);
  * @param state The State object to check.
  * @return true if the State object is a goal state, false otherwise.
  */
-bool is_goal_state(State state);
+bool is_goal_state(const State *state);
 
 /**
  * Calculates the sum of all elements in a State object.
@@ -144,7 +235,7 @@ bool is_goal_state(State state);
  * @param state The State object.
  * @return The sum of all elements.
  */
-int sum_elements(State *state);
+int sum_elements(const State *state);
 
 /**
  * Adds an element to a State object at a specified index.
@@ -164,6 +255,28 @@ bool add_element(State *state, uint8_t element, uint8_t index);
  */
 void array_to_state(State *state, uint8_t array[]);
 
+/**
+ * Parses a State object written as its columns, each as its cells from the
+ * bottom up with 0 for an empty cell, e.g. "921 570 680 430" on 4 columns of
+ * height 3. Whitespace may separate the columns and end the string.
+ *
+ * @param string The string to parse.
+ * @param state The State object to populate.
+ * @return true if the string holds every block exactly once, with no empty
+ * cell below a block, false otherwise.
+ */
+bool parse_state(const char *string, State *state);
+
+/**
+ * Returns the Movement object that leads from a State object to one of its
+ * successors.
+ *
+ * @param state The State object.
+ * @param successor The successor, one movement away from state.
+ * @return The Movement object.
+ */
+Movement movement_between_states(const State *state, const State *successor);
+
 /**
  * Checks if a Movement object is valid for a given State object.
  *
@@ -171,26 +284,28 @@ void array_to_state(State *state, uint8_t array[]);
  * @param movement The Movement object to check.
  * @return true if the Movement object is valid, false otherwise.
  */
-bool is_movement_valid(State state, Movement movement);
+bool is_movement_valid(const State *state, Movement movement);
 
 /**
- * Returns an array of possible Movement objects for a given State object.
+ * Writes the possible Movement objects for a given State object to a caller
+ * provided array, without allocating.
  *
  * @param state The State object.
- * @param nb_movement A pointer to an integer to store the number of possible
- * movements.
- * @return An array of possible Movement objects.
+ * @param movements The array to populate, of at least MAX_MOVEMENTS entries.
+ * @return The number of possible movements.
  */
-Movement *possible_movements(State state, int *nb_movement);
+int possible_movements(const State *state, Movement movements[]);
 
 /**
- * Generates all possible States objects that can be reached from a given State
- * object.
+ * Writes all possible State objects that can be reached from a given State
+ * object to a caller provided array, without allocating. Their predecessor
+ * is the given State object, which must outlive them.
  *
  * @param state The State object.
- * @return A States object containing all possible states.
+ * @param successors The array to populate, of at least MAX_MOVEMENTS entries.
+ * @return The number of possible states.
  */
-States possible_states(State state);
+int possible_states(State *state, State successors[]);
 
 /**
  * Checks if one State object is a predecessor of another State object.
@@ -207,7 +322,136 @@ bool is_predecessor(State *a, State *b);
  * @param state The State object to modify.
  * @param movement The Movement object to apply.
  */
-void apply_movement_to_state(State *state, Movement movement);
+static inline void apply_movement_to_state(State *state, Movement movement) {
+    assert(is_movement_valid(state, movement));
+    state->state[movement.to][state->nb_element[movement.to]] =
+        state->state[movement.from][state->nb_element[movement.from] - 1];
+    state->state[movement.from][state->nb_element[movement.from] - 1] = 0;
+    state->nb_element[movement.from]--;
+    state->nb_element[movement.to]++;
+}
+
+/**
+ * Reverts a Movement object applied to a State object by
+ * apply_movement_to_state().
+ *
+ * @param state The State object to modify.
+ * @param movement The Movement object to revert.
+ */
+static inline void undo_movement_to_state(State *state, Movement movement) {
+    Movement undo = {.from = movement.to, .to = movement.from};
+    apply_movement_to_state(state, undo);
+}
+
+/**
+ * Packs the grid of a State object in a PackedState.
+ *
+ * @param state The State object to pack.
+ * @return The packed state.
+ */
+PackedState pack_state(const State *state);
+
+/**
+ * Unpacks a PackedState in a State object. The predecessor and depth fields
+ * are reset.
+ *
+ * @param packed The packed state.
+ * @param state The State object to populate.
+ */
+void unpack_state(PackedState packed, State *state);
+
+/**
+ * Returns the number of elements of a column of a PackedState.
+ *
+ * @param packed The packed state.
+ * @param column The index of the column.
+ * @return The number of elements of the column.
+ */
+static inline int packed_height(PackedState packed, int column) {
+    return (packed >> (PACKED_HEIGHTS_OFFSET + 2 * column)) & 0x3;
+}
+
+/**
+ * Returns the height signature of a PackedState, its heights field.
+ *
+ * @param packed The packed state.
+ * @return The height signature, below NB_HEIGHT_SIGNATURES.
+ */
+static inline unsigned int height_signature(PackedState packed) {
+    return packed >> PACKED_HEIGHTS_OFFSET;
+}
+
+/**
+ * Returns the movements possible from the states of a height signature,
+ * from a table built on the first call.
+ *
+ * @param signature The height signature.
+ * @return The HeightMoves object of the signature.
+ */
+const HeightMoves *height_moves(unsigned int signature);
+
+/**
+ * Checks if a PackedState is a goal state. Same rule as is_goal_state().
+ *
+ * @param packed The packed state.
+ * @return true if the packed state is a goal state, false otherwise.
+ */
+bool is_packed_goal_state(PackedState packed);
+
+/**
+ * Returns every goal state, as recognized by is_packed_goal_state().
+ *
+ * @param nb_goal A pointer to an integer to store the number of goal states.
+ * @return An array of the packed goal states, to be freed by the caller.
+ */
+PackedState *packed_goal_states(int *nb_goal);
+
+/**
+ * Fills an array with the valid movements of a PackedState.
+ *
+ * @param packed The packed state.
+ * @param movements The array to fill, of at least MAX_MOVEMENTS elements.
+ * @return The number of valid movements.
+ */
+int packed_possible_movements(PackedState packed, Movement movements[]);
+
+/**
+ * Applies a valid Movement object to a PackedState.
+ *
+ * @param packed The packed state.
+ * @param movement The Movement object to apply.
+ * @return The packed state after the movement.
+ */
+PackedState apply_movement_to_packed_state(PackedState packed,
+                                           Movement movement);
+
+/**
+ * Returns the canonical form of a PackedState, its columns sorted by
+ * decreasing height then contents, the empty columns last.
+ *
+ * The goal test does not depend on the order of the columns, so the states
+ * differing only by it, up to STATE_WIDTH! of them, are at the same distance
+ * from a goal and share their canonical form. Searching over the canonical
+ * forms visits each class of states once; a movement between two canonical
+ * forms is a movement between some of their states, whose columns can be
+ * relabelled back with canonical_movement().
+ *
+ * @param packed The packed state.
+ * @return The packed state with its columns in canonical order.
+ */
+PackedState canonical_packed_state(PackedState packed);
+
+/**
+ * Finds the movement of a PackedState leading to a state with a given
+ * canonical form.
+ *
+ * @param packed The packed state, with any column order.
+ * @param successor The canonical form of a successor of the state.
+ * @param movement A pointer to store the movement, in the columns of packed.
+ * @return true if such a movement exists, false otherwise.
+ */
+bool canonical_movement(PackedState packed, PackedState successor,
+                        Movement *movement);
 
 /**
  * Prints the contents of a State object.
@@ -216,6 +460,14 @@ void apply_movement_to_state(State *state, Movement movement);
  */
 void print_state(State *state);
 
+/**
+ * Prints the contents of a State object to a stream.
+ *
+ * @param stream The stream to print to.
+ * @param state The State object to print.
+ */
+void fprint_state(FILE *stream, State *state);
+
 /**
  * Prints the raw contents of a State object.
  *
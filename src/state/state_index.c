@@ -0,0 +1,139 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation for State indexing
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "state_index.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <threads.h>
+
+/*-----------------------------------------------------------------*/
+
+static once_flag tables_once = ONCE_FLAG_INIT;
+static int configuration_of_signature[NB_HEIGHT_SIGNATURES];
+static PackedState signature_of_configuration[NB_HEIGHT_SIGNATURES];
+static unsigned int nb_configurations;
+static StateIndex factorials[NB_BLOCKS + 1];
+
+static void init_tables(void) {
+    factorials[0] = 1;
+    for (int i = 1; i <= NB_BLOCKS; i++) {
+        factorials[i] = factorials[i - 1] * i;
+    }
+    nb_configurations = 0;
+    for (int signature = 0; signature < NB_HEIGHT_SIGNATURES; signature++) {
+        int sum = 0;
+        bool valid = true;
+        for (int i = 0; i < STATE_WIDTH; i++) {
+            int height = (signature >> (2 * i)) & 0x3;
+            valid = valid && height <= STATE_HEIGHT;
+            sum += height;
+        }
+        if (valid && sum == NB_BLOCKS) {
+            configuration_of_signature[signature] = nb_configurations;
+            signature_of_configuration[nb_configurations] = signature;
+            nb_configurations++;
+        } else {
+            configuration_of_signature[signature] = -1;
+        }
+    }
+}
+
+static void ensure_tables(void) {
+    call_once(&tables_once, init_tables);
+}
+
+unsigned long long nb_state_indices(void) {
+    ensure_tables();
+    return (unsigned long long)nb_configurations * factorials[NB_BLOCKS];
+}
+
+unsigned int nb_height_configurations(void) {
+    ensure_tables();
+    return nb_configurations;
+}
+
+unsigned int height_configuration(PackedState packed) {
+    ensure_tables();
+    int configuration =
+        configuration_of_signature[height_signature(packed)];
+    assert(configuration >= 0);
+    return configuration;
+}
+
+StateIndex packed_state_index(PackedState packed) {
+    unsigned int configuration = height_configuration(packed);
+    // Lehmer code of the blocks, read column by column from the bottom up
+    StateIndex rank = 0;
+    unsigned int used = 0;
+    int position = 0;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        for (int j = 0; j < packed_height(packed, i); j++) {
+            int block = (packed >> PACKED_CELL_OFFSET(i, j)) & 0xF;
+            int smaller_left =
+                __builtin_popcount(~used & ((1u << block) - 1) & ~1u);
+            rank += smaller_left * factorials[NB_BLOCKS - 1 - position];
+            used |= 1u << block;
+            position++;
+        }
+    }
+    return configuration * factorials[NB_BLOCKS] + rank;
+}
+
+PackedState packed_state_from_index(StateIndex index) {
+    ensure_tables();
+    assert(index < nb_state_indices());
+    PackedState signature =
+        signature_of_configuration[index / factorials[NB_BLOCKS]];
+    StateIndex rank = index % factorials[NB_BLOCKS];
+    PackedState packed = signature << PACKED_HEIGHTS_OFFSET;
+    unsigned int used = 0;
+    int position = 0;
+    for (int i = 0; i < STATE_WIDTH; i++) {
+        for (int j = 0; j < packed_height(packed, i); j++) {
+            StateIndex factorial = factorials[NB_BLOCKS - 1 - position];
+            StateIndex smaller_left = rank / factorial;
+            rank %= factorial;
+            // Pick the (smaller_left + 1)-th block not used yet
+            int block = 1;
+            while (used & (1u << block) || smaller_left > 0) {
+                if (!(used & (1u << block)))
+                    smaller_left--;
+                block++;
+            }
+            used |= 1u << block;
+            packed |= (PackedState)block << PACKED_CELL_OFFSET(i, j);
+            position++;
+        }
+    }
+    return packed;
+}
+
+StateIndex state_index(const State *state) {
+    return packed_state_index(pack_state(state));
+}
+
+void state_from_index(StateIndex index, State *state) {
+    unpack_state(packed_state_from_index(index), state);
+}
+
+void init_state_bitset(StateBitset *bitset) {
+    bitset->words = calloc((nb_state_indices() + 63) / 64, sizeof(uint64_t));
+    assert(bitset->words != NULL);
+    bitset->size = 0;
+}
+
+void free_state_bitset(StateBitset *bitset) {
+    free(bitset->words);
+    bitset->words = NULL;
+    bitset->size = 0;
+}
+
+unsigned long long state_bitset_bytes(const StateBitset *bitset) {
+    return (nb_state_indices() + 63) / 64 * sizeof(uint64_t);
+}
@@ -0,0 +1,145 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for State indexing
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef STATE_INDEX_H
+#define STATE_INDEX_H
+#include "state.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * @typedef StateIndex
+ * @brief Dense index of a State, between 0 and nb_state_indices() - 1.
+ *
+ * The index of a state is the index of its column heights among all the
+ * valid height configurations, times NB_BLOCKS!, plus the rank of the order
+ * in which its blocks appear, column by column from the bottom up.
+ * Every valid state has exactly one index and every index one state.
+ */
+typedef uint32_t StateIndex;
+
+/**
+ * @struct StateBitset
+ * @brief One bit per StateIndex, used as a visited set.
+ */
+typedef struct s_state_bitset {
+    uint64_t *words;
+    unsigned long long size;
+} StateBitset;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Returns the number of valid states, that is the number of column height
+ * configurations times NB_BLOCKS!.
+ *
+ * @return The number of state indices.
+ */
+unsigned long long nb_state_indices(void);
+
+/**
+ * Returns the number of valid column height configurations.
+ *
+ * @return The number of height configurations.
+ */
+unsigned int nb_height_configurations(void);
+
+/**
+ * Returns the index of the column height configuration of a PackedState.
+ *
+ * @param packed The packed state.
+ * @return The index of its height configuration.
+ */
+unsigned int height_configuration(PackedState packed);
+
+/**
+ * Returns the dense index of a PackedState.
+ *
+ * @param packed The packed state.
+ * @return The index of the state.
+ */
+StateIndex packed_state_index(PackedState packed);
+
+/**
+ * Returns the PackedState with a given dense index.
+ *
+ * @param index The index, lower than nb_state_indices().
+ * @return The packed state.
+ */
+PackedState packed_state_from_index(StateIndex index);
+
+/**
+ * Returns the dense index of a State object.
+ *
+ * @param state The State object.
+ * @return The index of the state.
+ */
+StateIndex state_index(const State *state);
+
+/**
+ * Populates a State object from its dense index.
+ *
+ * @param index The index, lower than nb_state_indices().
+ * @param state The State object to populate.
+ */
+void state_from_index(StateIndex index, State *state);
+
+/**
+ * Initializes a StateBitset covering every state index, with no bit set.
+ *
+ * @param bitset The StateBitset object to initialize.
+ */
+void init_state_bitset(StateBitset *bitset);
+
+/**
+ * Releases the memory held by a StateBitset.
+ *
+ * @param bitset The StateBitset object to free.
+ */
+void free_state_bitset(StateBitset *bitset);
+
+/**
+ * Returns the number of bytes held by a StateBitset.
+ *
+ * @param bitset The StateBitset object.
+ * @return The size of the bitset in bytes.
+ */
+unsigned long long state_bitset_bytes(const StateBitset *bitset);
+
+/**
+ * Sets the bit of a state index.
+ *
+ * @param bitset The StateBitset object.
+ * @param index The state index.
+ * @return true if the bit was not set before, false otherwise.
+ */
+static inline bool add_index_to_bitset(StateBitset *bitset, StateIndex index) {
+    uint64_t mask = (uint64_t)1 << (index & 63);
+    uint64_t *word = &bitset->words[index >> 6];
+    if (*word & mask)
+        return false;
+    *word |= mask;
+    bitset->size++;
+    return true;
+}
+
+/**
+ * Checks if the bit of a state index is set.
+ *
+ * @param bitset The StateBitset object.
+ * @param index The state index.
+ * @return true if the bit is set, false otherwise.
+ */
+static inline bool is_index_in_bitset(const StateBitset *bitset,
+                                      StateIndex index) {
+    return (bitset->words[index >> 6] >> (index & 63)) & 1;
+}
+
+#endif // STATE_INDEX_H
@@ -0,0 +1,174 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation for State sets
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "state_set.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Returns the slot holding key, or the empty slot where it would be inserted,
+ * and adds the number of inspected slots to the probe counters.
+ */
+static unsigned long long find_slot(const PackedState *keys,
+                                    unsigned long long capacity,
+                                    PackedState key,
+                                    ProbeCounters *counters) {
+    unsigned long long mask = capacity - 1;
+    unsigned long long slot = hash_packed_state(key) & mask;
+    unsigned long long probe = 1;
+    while (keys[slot] != 0 && keys[slot] != key) {
+        slot = (slot + 1) & mask;
+        probe++;
+    }
+    counters->lookups++;
+    counters->probes += probe;
+    if (probe > counters->max_probe)
+        counters->max_probe = probe;
+    return slot;
+}
+
+/**
+ * Returns the empty slot of a freshly grown table where key is to be moved.
+ */
+static unsigned long long rehash_slot(const PackedState *keys,
+                                      unsigned long long capacity,
+                                      PackedState key) {
+    unsigned long long mask = capacity - 1;
+    unsigned long long slot = hash_packed_state(key) & mask;
+    while (keys[slot] != 0)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+static void grow_state_set(StateSet *set) {
+    PackedState *old_keys = set->keys;
+    unsigned long long old_capacity = set->capacity;
+    set->capacity =
+        old_capacity == 0 ? STATE_SET_INITIAL_CAPACITY : old_capacity * 2;
+    set->keys = calloc(set->capacity, sizeof(PackedState));
+    assert(set->keys != NULL);
+    for (unsigned long long i = 0; i < old_capacity; i++) {
+        if (old_keys[i] == 0)
+            continue;
+        set->keys[rehash_slot(set->keys, set->capacity, old_keys[i])] =
+            old_keys[i];
+    }
+    free(old_keys);
+}
+
+static void grow_state_map(StateMap *map) {
+    PackedState *old_keys = map->keys;
+    uint32_t *old_values = map->values;
+    unsigned long long old_capacity = map->capacity;
+    map->capacity =
+        old_capacity == 0 ? STATE_SET_INITIAL_CAPACITY : old_capacity * 2;
+    map->keys = calloc(map->capacity, sizeof(PackedState));
+    map->values = malloc(map->capacity * sizeof(uint32_t));
+    assert(map->keys != NULL && map->values != NULL);
+    for (unsigned long long i = 0; i < old_capacity; i++) {
+        if (old_keys[i] == 0)
+            continue;
+        unsigned long long slot =
+            rehash_slot(map->keys, map->capacity, old_keys[i]);
+        map->keys[slot] = old_keys[i];
+        map->values[slot] = old_values[i];
+    }
+    free(old_keys);
+    free(old_values);
+}
+
+void init_state_set(StateSet *set) {
+    set->keys = NULL;
+    set->capacity = 0;
+    set->size = 0;
+    set->counters.lookups = 0;
+    set->counters.probes = 0;
+    set->counters.max_probe = 0;
+}
+
+void free_state_set(StateSet *set) {
+    free(set->keys);
+    init_state_set(set);
+}
+
+bool add_key_to_set(StateSet *set, PackedState key) {
+    assert(key != 0);
+    if (2 * (set->size + 1) > set->capacity)
+        grow_state_set(set);
+    unsigned long long slot =
+        find_slot(set->keys, set->capacity, key, &set->counters);
+    if (set->keys[slot] == key)
+        return false;
+    set->keys[slot] = key;
+    set->size++;
+    return true;
+}
+
+bool is_key_in_set(StateSet *set, PackedState key) {
+    if (set->size == 0)
+        return false;
+    unsigned long long slot =
+        find_slot(set->keys, set->capacity, key, &set->counters);
+    return set->keys[slot] == key;
+}
+
+double state_set_load_factor(const StateSet *set) {
+    if (set->capacity == 0)
+        return 0;
+    return (double)set->size / (double)set->capacity;
+}
+
+double state_set_mean_probe(const StateSet *set) {
+    if (set->counters.lookups == 0)
+        return 0;
+    return (double)set->counters.probes / (double)set->counters.lookups;
+}
+
+void init_state_map(StateMap *map) {
+    map->keys = NULL;
+    map->values = NULL;
+    map->capacity = 0;
+    map->size = 0;
+    map->counters.lookups = 0;
+    map->counters.probes = 0;
+    map->counters.max_probe = 0;
+}
+
+void free_state_map(StateMap *map) {
+    free(map->keys);
+    free(map->values);
+    init_state_map(map);
+}
+
+bool put_in_state_map(StateMap *map, PackedState key, uint32_t value) {
+    assert(key != 0);
+    if (2 * (map->size + 1) > map->capacity)
+        grow_state_map(map);
+    unsigned long long slot =
+        find_slot(map->keys, map->capacity, key, &map->counters);
+    map->values[slot] = value;
+    if (map->keys[slot] == key)
+        return false;
+    map->keys[slot] = key;
+    map->size++;
+    return true;
+}
+
+bool get_from_state_map(StateMap *map, PackedState key, uint32_t *value) {
+    if (map->size == 0)
+        return false;
+    unsigned long long slot =
+        find_slot(map->keys, map->capacity, key, &map->counters);
+    if (map->keys[slot] != key)
+        return false;
+    *value = map->values[slot];
+    return true;
+}
@@ -0,0 +1,163 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for State sets
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef STATE_SET_H
+#define STATE_SET_H
+#include "state.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initial number of slots of a StateSet. Must be a power of two.
+ */
+#define STATE_SET_INITIAL_CAPACITY 1024
+
+/**
+ * @struct ProbeCounters
+ * @brief Cumulative probe statistics of a StateSet or StateMap.
+ */
+typedef struct s_probe_counters {
+    unsigned long long lookups;
+    unsigned long long probes;
+    unsigned long long max_probe;
+} ProbeCounters;
+
+/**
+ * @struct StateSet
+ * @brief Open-addressing hash set of packed states.
+ *
+ * The key 0 never encodes a valid state and marks an empty slot. Collisions
+ * are resolved by linear probing, and the table doubles once it is half full.
+ * @note The probe counters are cumulative over the lifetime of the set and
+ * are meant to be reported alongside the search statistics.
+ */
+typedef struct s_state_set {
+    PackedState *keys;
+    unsigned long long capacity;
+    unsigned long long size;
+    ProbeCounters counters;
+} StateSet;
+
+/**
+ * @struct StateMap
+ * @brief Open-addressing hash map from packed states to 32-bit values.
+ *
+ * Same layout and probing as StateSet, with one value stored next to each
+ * key, e.g. the index of the search node holding the state.
+ */
+typedef struct s_state_map {
+    PackedState *keys;
+    uint32_t *values;
+    unsigned long long capacity;
+    unsigned long long size;
+    ProbeCounters counters;
+} StateMap;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Hashes a packed state, spreading its nibbles over the whole word.
+ *
+ * @param key The packed state.
+ * @return The hash of the packed state.
+ */
+static inline uint64_t hash_packed_state(PackedState key) {
+    // splitmix64 finalizer
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+/**
+ * Initializes an empty StateSet.
+ *
+ * @param set The StateSet object to initialize.
+ */
+void init_state_set(StateSet *set);
+
+/**
+ * Releases the memory held by a StateSet and resets it to an empty set.
+ *
+ * @param set The StateSet object to free.
+ */
+void free_state_set(StateSet *set);
+
+/**
+ * Inserts a key in a StateSet.
+ *
+ * @param set The StateSet object.
+ * @param key The packed state to insert.
+ * @return true if the key was not already in the set, false otherwise.
+ */
+bool add_key_to_set(StateSet *set, PackedState key);
+
+/**
+ * Checks if a key is present in a StateSet.
+ *
+ * @param set The StateSet object.
+ * @param key The packed state to look for.
+ * @return true if the key is present, false otherwise.
+ */
+bool is_key_in_set(StateSet *set, PackedState key);
+
+/**
+ * Returns the ratio of used slots to allocated slots of a StateSet.
+ *
+ * @param set The StateSet object.
+ * @return The load factor, between 0 and 0.5.
+ */
+double state_set_load_factor(const StateSet *set);
+
+/**
+ * Returns the average number of slots inspected per lookup in a StateSet.
+ *
+ * @param set The StateSet object.
+ * @return The mean probe length, 0 if no lookup was made.
+ */
+double state_set_mean_probe(const StateSet *set);
+
+/**
+ * Initializes an empty StateMap.
+ *
+ * @param map The StateMap object to initialize.
+ */
+void init_state_map(StateMap *map);
+
+/**
+ * Releases the memory held by a StateMap and resets it to an empty map.
+ *
+ * @param map The StateMap object to free.
+ */
+void free_state_map(StateMap *map);
+
+/**
+ * Associates a value with a key in a StateMap, replacing any previous value.
+ *
+ * @param map The StateMap object.
+ * @param key The packed state.
+ * @param value The value to store.
+ * @return true if the key was not already in the map, false otherwise.
+ */
+bool put_in_state_map(StateMap *map, PackedState key, uint32_t value);
+
+/**
+ * Looks up the value associated with a key in a StateMap.
+ *
+ * @param map The StateMap object.
+ * @param key The packed state.
+ * @param value Where to store the value, if the key is present.
+ * @return true if the key is present, false otherwise.
+ */
+bool get_from_state_map(StateMap *map, PackedState key, uint32_t *value);
+
+#endif // STATE_SET_H
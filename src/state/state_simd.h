@@ -0,0 +1,194 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for SIMD State kernels
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef STATE_SIMD_H
+#define STATE_SIMD_H
+#include "state.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * The 4x3 grid of a State and its 4 column heights are its first 16 bytes:
+ * byte 3 * i + j holds the element at level j of column i, and byte 12 + i
+ * the height of column i. The kernels below load them in one SSE2 register,
+ * or two States in one AVX2 register, and replace the nested loops and
+ * branches of the scalar code with a few compares and masks. STATE_SIMD is
+ * only defined when the target has SSE2, the State has this layout and
+ * STATE_NO_SIMD is not defined; the callers keep their scalar loops
+ * otherwise.
+ */
+#if defined(__SSE2__) && STATE_WIDTH == 4 && STATE_HEIGHT == 3 &&             \
+    !defined(STATE_NO_SIMD)
+#define STATE_SIMD 1
+#include <emmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+_Static_assert(offsetof(State, nb_element) == STATE_WIDTH * STATE_HEIGHT &&
+                   offsetof(State, predecessor) >= 16,
+               "the grid and heights of a State must be its first 16 bytes");
+
+/**
+ * Bits of the movemask of a grid set for the cells that have a cell above
+ * them in their column, i.e. the levels 0 and 1 of every column.
+ */
+#define SIMD_PAIR_MASK 0x06DB
+
+/**
+ * Bits of the movemask of a grid set for the column heights.
+ */
+#define SIMD_HEIGHT_MASK 0xF000
+
+/*-----------------------------------------------------------------*/
+
+static inline __m128i load_grid(const State *state) {
+    return _mm_loadu_si128((const __m128i *)state);
+}
+
+/**
+ * Returns the movemask of the bytes of a grid that satisfy the goal rule: a
+ * cell is empty or right above the next larger block, a height is 0 or full.
+ * Only the bits of SIMD_PAIR_MASK and SIMD_HEIGHT_MASK are meaningful.
+ */
+static inline int goal_rule_mask(__m128i grid) {
+    // Shift the grid down one byte to line each cell up with the one above
+    __m128i above = _mm_srli_si128(grid, 1);
+    __m128i empty = _mm_cmpeq_epi8(grid, _mm_setzero_si128());
+    __m128i stacked =
+        _mm_cmpeq_epi8(_mm_sub_epi8(grid, above), _mm_set1_epi8(1));
+    __m128i full = _mm_cmpeq_epi8(grid, _mm_set1_epi8(STATE_HEIGHT));
+    int pairs = _mm_movemask_epi8(_mm_or_si128(empty, stacked));
+    int heights = _mm_movemask_epi8(_mm_or_si128(empty, full));
+    return (pairs & SIMD_PAIR_MASK) | (heights & SIMD_HEIGHT_MASK);
+}
+
+static inline bool is_same_grid_simd(const State *s1, const State *s2) {
+    __m128i equal = _mm_cmpeq_epi8(load_grid(s1), load_grid(s2));
+    return _mm_movemask_epi8(equal) == 0xFFFF;
+}
+
+static inline bool is_goal_grid_simd(const State *state) {
+    return goal_rule_mask(load_grid(state)) ==
+           (SIMD_PAIR_MASK | SIMD_HEIGHT_MASK);
+}
+
+static inline int misplaced_cubes_simd(const State *state) {
+    int broken = ~goal_rule_mask(load_grid(state));
+    return __builtin_popcount(broken & (SIMD_PAIR_MASK | SIMD_HEIGHT_MASK));
+}
+
+/**
+ * Returns, per cell of a grid, the distance from the column and level of the
+ * cell to those of the goal position of its block, assuming it is not empty.
+ */
+static inline __m128i goal_distances(__m128i grid) {
+    const __m128i columns =
+        _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 0, 0, 0, 0);
+    const __m128i levels =
+        _mm_setr_epi8(0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 0, 0, 0);
+    __m128i index = _mm_sub_epi8(grid, _mm_set1_epi8(1));
+    // (index * 86) >> 8 is index / 3 for every index of a block
+    __m128i low = _mm_unpacklo_epi8(index, _mm_setzero_si128());
+    __m128i high = _mm_unpackhi_epi8(index, _mm_setzero_si128());
+    low = _mm_srli_epi16(_mm_mullo_epi16(low, _mm_set1_epi16(86)), 8);
+    high = _mm_srli_epi16(_mm_mullo_epi16(high, _mm_set1_epi16(86)), 8);
+    __m128i goal_columns = _mm_packus_epi16(low, high);
+    __m128i goal_levels = _mm_sub_epi8(
+        index, _mm_add_epi8(goal_columns,
+                            _mm_add_epi8(goal_columns, goal_columns)));
+    __m128i column_distances =
+        _mm_sub_epi8(_mm_max_epu8(columns, goal_columns),
+                     _mm_min_epu8(columns, goal_columns));
+    __m128i level_distances = _mm_sub_epi8(_mm_max_epu8(levels, goal_levels),
+                                           _mm_min_epu8(levels, goal_levels));
+    return _mm_add_epi8(column_distances, level_distances);
+}
+
+/**
+ * Returns a byte mask of the cells of a grid whose block is not right above
+ * the next larger one.
+ */
+static inline __m128i misplaced_cells(__m128i grid) {
+    const __m128i pairs = _mm_setr_epi8(-1, -1, 0, -1, -1, 0, -1, -1, 0, -1,
+                                        -1, 0, 0, 0, 0, 0);
+    __m128i above = _mm_srli_si128(grid, 1);
+    __m128i empty = _mm_cmpeq_epi8(grid, _mm_setzero_si128());
+    __m128i stacked =
+        _mm_cmpeq_epi8(_mm_sub_epi8(grid, above), _mm_set1_epi8(1));
+    return _mm_andnot_si128(_mm_or_si128(empty, stacked), pairs);
+}
+
+static inline int manhattan_distance_simd(const State *state) {
+    __m128i grid = load_grid(state);
+    int broken = ~goal_rule_mask(grid) & SIMD_HEIGHT_MASK;
+    __m128i distances =
+        _mm_and_si128(goal_distances(grid), misplaced_cells(grid));
+    __m128i sums = _mm_sad_epu8(distances, _mm_setzero_si128());
+    return __builtin_popcount(broken) + _mm_cvtsi128_si32(sums) +
+           _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+}
+
+#ifdef __AVX2__
+/**
+ * Same as manhattan_distance_simd() for two grids at once, one per 128-bit
+ * lane. Every instruction used works lane by lane.
+ */
+static inline void manhattan_distance_pair_avx2(const State *s1,
+                                                const State *s2,
+                                                int distances[2]) {
+    __m256i grids = _mm256_set_m128i(load_grid(s2), load_grid(s1));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i columns =
+        _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2,
+                                                  3, 3, 3, 0, 0, 0, 0));
+    const __m256i levels =
+        _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 1, 2, 0, 1, 2, 0, 1, 2,
+                                                  0, 1, 2, 0, 0, 0, 0));
+    const __m256i pairs = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+        -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, 0, 0, 0, 0));
+    __m256i above = _mm256_srli_si256(grids, 1);
+    __m256i empty = _mm256_cmpeq_epi8(grids, zero);
+    __m256i stacked =
+        _mm256_cmpeq_epi8(_mm256_sub_epi8(grids, above), _mm256_set1_epi8(1));
+    __m256i full = _mm256_cmpeq_epi8(grids, _mm256_set1_epi8(STATE_HEIGHT));
+    __m256i misplaced =
+        _mm256_andnot_si256(_mm256_or_si256(empty, stacked), pairs);
+    unsigned int heights =
+        ~(unsigned int)_mm256_movemask_epi8(_mm256_or_si256(empty, full));
+
+    __m256i index = _mm256_sub_epi8(grids, _mm256_set1_epi8(1));
+    __m256i low = _mm256_unpacklo_epi8(index, zero);
+    __m256i high = _mm256_unpackhi_epi8(index, zero);
+    low = _mm256_srli_epi16(_mm256_mullo_epi16(low, _mm256_set1_epi16(86)), 8);
+    high =
+        _mm256_srli_epi16(_mm256_mullo_epi16(high, _mm256_set1_epi16(86)), 8);
+    __m256i goal_columns = _mm256_packus_epi16(low, high);
+    __m256i goal_levels = _mm256_sub_epi8(
+        index, _mm256_add_epi8(goal_columns,
+                               _mm256_add_epi8(goal_columns, goal_columns)));
+    __m256i sum = _mm256_add_epi8(
+        _mm256_sub_epi8(_mm256_max_epu8(columns, goal_columns),
+                        _mm256_min_epu8(columns, goal_columns)),
+        _mm256_sub_epi8(_mm256_max_epu8(levels, goal_levels),
+                        _mm256_min_epu8(levels, goal_levels)));
+    __m256i sums = _mm256_sad_epu8(_mm256_and_si256(sum, misplaced), zero);
+    distances[0] = __builtin_popcount(heights & SIMD_HEIGHT_MASK) +
+                   _mm256_extract_epi64(sums, 0) +
+                   _mm256_extract_epi64(sums, 1);
+    distances[1] = __builtin_popcount((heights >> 16) & SIMD_HEIGHT_MASK) +
+                   _mm256_extract_epi64(sums, 2) +
+                   _mm256_extract_epi64(sums, 3);
+}
+#endif // __AVX2__
+
+#endif // STATE_SIMD
+
+#endif // STATE_SIMD_H
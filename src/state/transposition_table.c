@@ -0,0 +1,138 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation for Transposition tables
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "transposition_table.h"
+#include "state_set.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*-----------------------------------------------------------------*/
+
+_Static_assert(TRANSPOSITION_BUCKET_SIZE == 2,
+               "the replacement policy is written for two-entry buckets");
+
+static TranspositionEntry *bucket_of(const TranspositionTable *table,
+                                     PackedState key) {
+    unsigned long long bucket =
+        hash_packed_state(key) & (table->nb_buckets - 1);
+    return &table->entries[bucket * TRANSPOSITION_BUCKET_SIZE];
+}
+
+void init_transposition_table(TranspositionTable *table, size_t bytes) {
+    size_t bucket_bytes =
+        TRANSPOSITION_BUCKET_SIZE * sizeof(TranspositionEntry);
+    table->nb_buckets = 1;
+    while (table->nb_buckets * 2 * bucket_bytes <= bytes) {
+        table->nb_buckets *= 2;
+    }
+    // Fresh zeroed pages: only the buckets used are ever touched
+    table->entries = calloc(table->nb_buckets * TRANSPOSITION_BUCKET_SIZE,
+                            sizeof(TranspositionEntry));
+    assert(table->entries != NULL);
+    table->generation = 1;
+    table->size = 0;
+    table->counters = (TranspositionCounters){0, 0, 0, 0};
+}
+
+void free_transposition_table(TranspositionTable *table) {
+    free(table->entries);
+    table->entries = NULL;
+    table->nb_buckets = 0;
+    table->size = 0;
+}
+
+void clear_transposition_table(TranspositionTable *table) {
+    table->generation++;
+    if (table->generation == 0) {
+        // The generations wrapped around, the oldest entries would come back
+        memset(table->entries, 0, transposition_table_bytes(table));
+        table->generation = 1;
+    }
+    table->size = 0;
+    table->counters = (TranspositionCounters){0, 0, 0, 0};
+}
+
+/**
+ * Checks if an entry holds a state stored since the last clearing.
+ */
+static inline bool is_entry_used(const TranspositionTable *table,
+                                 const TranspositionEntry *entry) {
+    return entry->key != 0 && entry->generation == table->generation;
+}
+
+const TranspositionEntry *probe_transposition_table(TranspositionTable *table,
+                                                    PackedState key) {
+    const TranspositionEntry *bucket = bucket_of(table, key);
+    for (int i = 0; i < TRANSPOSITION_BUCKET_SIZE; i++) {
+        if (bucket[i].key == key && is_entry_used(table, &bucket[i])) {
+            table->counters.hits++;
+            return &bucket[i];
+        }
+    }
+    table->counters.misses++;
+    return NULL;
+}
+
+void store_in_transposition_table(TranspositionTable *table, PackedState key,
+                                  int depth, double bound) {
+    TranspositionEntry entry = {
+        .key = key,
+        .generation = table->generation,
+        .depth = depth < UINT16_MAX ? depth : UINT16_MAX,
+        .bound = bound < UINT16_MAX ? (bound > 0 ? bound : 0) : UINT16_MAX,
+    };
+    TranspositionEntry *bucket = bucket_of(table, key);
+    table->counters.stores++;
+    for (int i = 0; i < TRANSPOSITION_BUCKET_SIZE; i++) {
+        if (bucket[i].key == key && is_entry_used(table, &bucket[i])) {
+            if (entry.bound > bucket[i].bound)
+                bucket[i].bound = entry.bound;
+            if (entry.depth < bucket[i].depth)
+                bucket[i].depth = entry.depth;
+            return;
+        }
+    }
+
+    // A state searched from closer to the root takes the first entry,
+    // demoting its state to the second one, which is always replaced
+    bool first_used = is_entry_used(table, &bucket[0]);
+    bool second_used = is_entry_used(table, &bucket[1]);
+    if (first_used && entry.depth > bucket[0].depth) {
+        table->counters.replacements += second_used;
+        table->size += !second_used;
+        bucket[1] = entry;
+    } else if (first_used) {
+        table->counters.replacements += second_used;
+        table->size += !second_used;
+        bucket[1] = bucket[0];
+        bucket[0] = entry;
+    } else {
+        table->size++;
+        bucket[0] = entry;
+    }
+}
+
+size_t transposition_table_bytes(const TranspositionTable *table) {
+    return table->nb_buckets * TRANSPOSITION_BUCKET_SIZE *
+           sizeof(TranspositionEntry);
+}
+
+double transposition_hit_rate(const TranspositionTable *table) {
+    unsigned long long probes = table->counters.hits + table->counters.misses;
+    return probes > 0 ? (double)table->counters.hits / probes : 0.0;
+}
+
+double transposition_replacement_rate(const TranspositionTable *table) {
+    return table->counters.stores > 0 ? (double)table->counters.replacements /
+                                            table->counters.stores
+                                      : 0.0;
+}
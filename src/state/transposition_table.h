@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for Transposition tables
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+#include "state.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Number of entries of a bucket of a TranspositionTable: one kept for the
+ * state reached the closest to the root, one always replaced.
+ */
+#define TRANSPOSITION_BUCKET_SIZE 2
+
+/**
+ * @struct TranspositionEntry
+ * @brief What a search learned about a state.
+ *
+ * bound is a lower bound on the cost from the state to a goal, at least its
+ * heuristic, and depth the smallest depth the state was searched from. The
+ * bound only depends on the state, so it holds across the iterations of a
+ * search. The key 0 never encodes a valid state and marks an empty entry, as
+ * does a generation other than the one of the table.
+ */
+typedef struct s_transposition_entry {
+    PackedState key;
+    uint32_t generation;
+    uint16_t depth;
+    uint16_t bound;
+} TranspositionEntry;
+
+/**
+ * @struct TranspositionCounters
+ * @brief Cumulative statistics of a TranspositionTable.
+ *
+ * hits and misses count the probes, stores the entries written and
+ * replacements the stores that evicted another state.
+ */
+typedef struct s_transposition_counters {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long stores;
+    unsigned long long replacements;
+} TranspositionCounters;
+
+/**
+ * @struct TranspositionTable
+ * @brief Fixed-size hash table of TranspositionEntry objects.
+ *
+ * The table never grows: a state is only ever stored in the bucket of its
+ * hash, evicting an entry when the bucket is full. The first entry of a
+ * bucket keeps the state searched from the smallest depth, whose subtree is
+ * the largest, and the second one takes the other states, so the memory of
+ * the table stays capped whatever the size of the search. Clearing the table
+ * only starts a new generation, so one table serves many searches without
+ * touching its memory again.
+ */
+typedef struct s_transposition_table {
+    TranspositionEntry *entries;
+    unsigned long long nb_buckets;
+    uint32_t generation;
+    unsigned long long size;
+    TranspositionCounters counters;
+} TranspositionTable;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Initializes an empty TranspositionTable with as many buckets as fit in a
+ * memory budget, rounded down to a power of two, and at least one.
+ *
+ * @param table The TranspositionTable object to initialize.
+ * @param bytes The memory budget of the table, in bytes.
+ */
+void init_transposition_table(TranspositionTable *table, size_t bytes);
+
+/**
+ * Releases the memory held by a TranspositionTable.
+ *
+ * @param table The TranspositionTable object to free.
+ */
+void free_transposition_table(TranspositionTable *table);
+
+/**
+ * Empties a TranspositionTable and resets its counters, for a new search.
+ *
+ * @param table The TranspositionTable object to clear.
+ */
+void clear_transposition_table(TranspositionTable *table);
+
+/**
+ * Looks up a state in a TranspositionTable, counting a hit or a miss.
+ *
+ * @param table The TranspositionTable object.
+ * @param key The packed state.
+ * @return The entry of the state, or NULL if it is not in the table.
+ */
+const TranspositionEntry *probe_transposition_table(TranspositionTable *table,
+                                                    PackedState key);
+
+/**
+ * Stores what a search learned about a state in a TranspositionTable. An
+ * entry already holding the state keeps the largest bound and the smallest
+ * depth.
+ *
+ * @param table The TranspositionTable object.
+ * @param key The packed state.
+ * @param depth The depth the state was searched from.
+ * @param bound The lower bound on the cost from the state to a goal, clamped
+ * to UINT16_MAX.
+ */
+void store_in_transposition_table(TranspositionTable *table, PackedState key,
+                                  int depth, double bound);
+
+/**
+ * Returns the number of bytes allocated for a TranspositionTable.
+ *
+ * @param table The TranspositionTable object.
+ * @return The size of its entries, in bytes.
+ */
+size_t transposition_table_bytes(const TranspositionTable *table);
+
+/**
+ * Returns the ratio of probes of a TranspositionTable that found their state.
+ *
+ * @param table The TranspositionTable object.
+ * @return The hit rate, 0 if no probe was made.
+ */
+double transposition_hit_rate(const TranspositionTable *table);
+
+/**
+ * Returns the ratio of stores in a TranspositionTable that evicted another
+ * state.
+ *
+ * @param table The TranspositionTable object.
+ * @return The replacement rate, 0 if nothing was stored.
+ */
+double transposition_replacement_rate(const TranspositionTable *table);
+
+#endif // TRANSPOSITION_TABLE_H
@@ -0,0 +1,127 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Implementation of precomputed Table files
+ **/
+/*-----------------------------------------------------------------*/
+
+#include "table_file.h"
+#include "state.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*-----------------------------------------------------------------*/
+
+static const char TABLE_FILE_MAGIC[8] = "SRCHTBL";
+
+_Static_assert(sizeof(TableFileHeader) == 64,
+               "the tables must stay 64-byte aligned");
+
+static void fill_header(TableFileHeader *header, uint32_t kind,
+                        uint32_t parameter, uint64_t nb_tables,
+                        uint64_t table_size) {
+    memset(header, 0, sizeof(TableFileHeader));
+    memcpy(header->magic, TABLE_FILE_MAGIC, sizeof(header->magic));
+    header->version = TABLE_FILE_VERSION;
+    header->kind = kind;
+    header->state_width = STATE_WIDTH;
+    header->state_height = STATE_HEIGHT;
+    header->nb_blocks = NB_BLOCKS;
+    header->parameter = parameter;
+    header->nb_tables = nb_tables;
+    header->table_size = table_size;
+}
+
+uint64_t table_checksum(const uint8_t *data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+bool write_table_file(const char *filename, uint32_t kind, uint32_t parameter,
+                      uint64_t nb_tables, uint64_t table_size,
+                      const uint8_t *tables) {
+    TableFileHeader header;
+    uint64_t size = nb_tables * table_size;
+    fill_header(&header, kind, parameter, nb_tables, table_size);
+    header.checksum = table_checksum(tables, size);
+
+    char *temporary = malloc(strlen(filename) + 16);
+    if (temporary == NULL)
+        return false;
+    sprintf(temporary, "%s.%ld.tmp", filename, (long)getpid());
+    FILE *file = fopen(temporary, "wb");
+    if (file == NULL) {
+        free(temporary);
+        return false;
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(tables, 1, size, file) == size;
+    written = fclose(file) == 0 && written;
+    written = written && rename(temporary, filename) == 0;
+    if (!written)
+        remove(temporary);
+    free(temporary);
+    return written;
+}
+
+bool read_table_file_header(const char *filename, TableFileHeader *header) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+        return false;
+    bool read = fread(header, sizeof(TableFileHeader), 1, file) == 1;
+    fclose(file);
+    return read;
+}
+
+bool map_table_file(TableFile *file, const char *filename, uint32_t kind,
+                    uint32_t parameter, uint64_t nb_tables,
+                    uint64_t table_size) {
+    memset(file, 0, sizeof(TableFile));
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat file_stat;
+    uint64_t size = nb_tables * table_size;
+    if (fstat(fd, &file_stat) != 0 ||
+        (uint64_t)file_stat.st_size != sizeof(TableFileHeader) + size) {
+        close(fd);
+        return false;
+    }
+    void *mapping = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    TableFileHeader expected;
+    const TableFileHeader *header = mapping;
+    const uint8_t *tables = (const uint8_t *)mapping + sizeof(TableFileHeader);
+    fill_header(&expected, kind, parameter, nb_tables, table_size);
+    expected.checksum = header->checksum;
+    if (memcmp(header, &expected, sizeof(TableFileHeader)) != 0 ||
+        table_checksum(tables, size) != header->checksum) {
+        munmap(mapping, file_stat.st_size);
+        return false;
+    }
+    file->header = header;
+    file->tables = tables;
+    file->mapping = mapping;
+    file->mapping_size = file_stat.st_size;
+    return true;
+}
+
+void unmap_table_file(TableFile *file) {
+    if (file->mapping != NULL)
+        munmap(file->mapping, file->mapping_size);
+    memset(file, 0, sizeof(TableFile));
+}
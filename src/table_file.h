@@ -0,0 +1,127 @@
+/*-----------------------------------------------------------------*/
+/** Search Algorithms
+ *  @author LAMALMI Daoud
+ *  @date 29/11/2023
+ *  @file Interface for precomputed Table files
+ **/
+/*-----------------------------------------------------------------*/
+
+#ifndef TABLE_FILE_H
+#define TABLE_FILE_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Defines the version of the table file format. Files of another version are
+ * rejected.
+ */
+#define TABLE_FILE_VERSION 1
+
+/**
+ * Defines the kinds of table stored in a table file.
+ */
+#define TABLE_KIND_PATTERN_DATABASE 1
+#define TABLE_KIND_DISTANCE_TABLE 2
+
+/**
+ * @struct TableFileHeader
+ * @brief Header of a table file, followed by nb_tables tables of table_size
+ * bytes each.
+ *
+ * A file is only valid for the dimensions of the State it was generated
+ * with, so these are part of the header, along with a parameter specific to
+ * the kind of table. The checksum is the 64-bit FNV-1a hash of the tables.
+ * The header is 64 bytes long, so the tables are 64-byte aligned in a
+ * mapping.
+ */
+typedef struct s_table_file_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint32_t state_width;
+    uint32_t state_height;
+    uint32_t nb_blocks;
+    uint32_t parameter;
+    uint64_t nb_tables;
+    uint64_t table_size;
+    uint64_t checksum;
+    uint8_t reserved[8];
+} TableFileHeader;
+
+/**
+ * @struct TableFile
+ * @brief A table file mapped read-only in memory.
+ *
+ * Every process mapping the same file shares its pages in the page cache.
+ */
+typedef struct s_table_file {
+    const TableFileHeader *header;
+    const uint8_t *tables;
+    void *mapping;
+    size_t mapping_size;
+} TableFile;
+
+/*-----------------------------------------------------------------*/
+
+/**
+ * Computes the checksum of a table file payload.
+ *
+ * @param data The payload.
+ * @param size The size of the payload in bytes.
+ * @return The 64-bit FNV-1a hash of the payload.
+ */
+uint64_t table_checksum(const uint8_t *data, size_t size);
+
+/**
+ * Writes tables to a table file. The file is written under a temporary name
+ * then renamed, so readers never see a partial file.
+ *
+ * @param filename The name of the file.
+ * @param kind The kind of the tables.
+ * @param parameter The parameter of the tables.
+ * @param nb_tables The number of tables.
+ * @param table_size The size of each table in bytes.
+ * @param tables The tables, stored one after another.
+ * @return true if the file was written, false otherwise.
+ */
+bool write_table_file(const char *filename, uint32_t kind, uint32_t parameter,
+                      uint64_t nb_tables, uint64_t table_size,
+                      const uint8_t *tables);
+
+/**
+ * Reads the header of a table file, without checking it.
+ *
+ * @param filename The name of the file.
+ * @param header The TableFileHeader object to populate.
+ * @return true if the header was read, false otherwise.
+ */
+bool read_table_file_header(const char *filename, TableFileHeader *header);
+
+/**
+ * Maps a table file read-only, after checking that its header matches the
+ * expected kind, parameter and sizes, the current dimensions and the
+ * checksum of its tables.
+ *
+ * @param file The TableFile object to populate.
+ * @param filename The name of the file.
+ * @param kind The expected kind of the tables.
+ * @param parameter The expected parameter of the tables.
+ * @param nb_tables The expected number of tables.
+ * @param table_size The expected size of each table in bytes.
+ * @return true if the file was mapped, false if it is missing or invalid.
+ */
+bool map_table_file(TableFile *file, const char *filename, uint32_t kind,
+                    uint32_t parameter, uint64_t nb_tables,
+                    uint64_t table_size);
+
+/**
+ * Unmaps a table file.
+ *
+ * @param file The TableFile object to unmap.
+ */
+void unmap_table_file(TableFile *file);
+
+#endif // TABLE_FILE_H